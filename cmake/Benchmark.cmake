@@ -5,11 +5,16 @@ set(BENCHMARK_NAMES
   benchmark_complete
   benchmark_new_entry
   benchmark_extract_insert
-  benchmark_lookup)
+  benchmark_lookup
+  benchmark_prefix
+  benchmark_hash_index
+  benchmark_find_many
+  benchmark_parallel_build)
 
 foreach(BM IN ITEMS ${BENCHMARK_NAMES})
 
   add_executable(${BM} ${RADIX_BENCHMARK_DIR}/${BM}.cpp)
+  target_link_libraries(${BM} radix)
   set_target_properties(${BM} PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/benchmarkbin)
 
 endforeach()
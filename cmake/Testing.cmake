@@ -19,11 +19,30 @@ set(TEST_NAMES
   radix_swap
   radix_erase
   radix_iterator
-  radix_iterator_type)
+  radix_iterator_type
+  radix_fanout
+  radix_mapped_type
+  radix_long_keys
+  radix_allocator
+  radix_pmr
+  radix_compact
+  radix_set
+  radix_leaf_links
+  radix_root_index
+  radix_hash_index
+  radix_lookup_cache
+  radix_finger
+  radix_find_many
+  radix_bulk_load
+  radix_parallel_build
+  radix_merge
+  radix_split
+  radix_erase_range)
 
 foreach(TN IN ITEMS ${TEST_NAMES})
 
   add_executable(${TN} ${RADIX_TEST_DIR}/${TN}.cpp)
+  target_link_libraries(${TN} radix)
   set_target_properties(${TN} PROPERTIES RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/testbin)
   add_test(NAME ${TN} COMMAND ${TN})
 
@@ -11,7 +11,6 @@
 // INCLUDES //
 //////////////
 
-#include <map>
 #include <string>
 #include <vector>
 #include <type_traits>
@@ -20,6 +19,34 @@
 #include <iterator>
 #include <functional>
 #include <utility>
+#include <algorithm>
+#include <bit>
+#include <string_view>
+#include <ranges>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <span>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 //////////////////
 // DECLARATIONS //
@@ -27,64 +54,465 @@
 
 // Forward declaration for friend relation
 namespace xsm{
-  template <class T, class Compare> class radix;
+  template <class T, class Compare, class Allocator, class Options> class radix;
 }
 
 namespace xsm::detail{
-  // Aux function declaration
-  std::string StrDiff(const std::string&, const std::string&);
-
   // Forward declaration for friend relation
-  template <class T, class Compare, class ItType=T> class Iterator_impl;
-  template <class T, class Compare> class Node;
-  template <class T, class Compare> class Node_handle;
+  template <class T, class Compare, class Allocator, class Options, class ItType=T> class Iterator_impl;
+  template <class T, class Compare, class Allocator, class Options> class Node;
+  template <class T, class Compare, class Allocator, class Options> class Leaf_node;
+  template <class T, class Compare, class Allocator, class Options> class Inner_node;
+  template <class T, class Compare, class Allocator, class Options> class Node_handle;
+  template <class T, class Compare, class Allocator, class Options> class Bulk_loader;
+  template <class T, class Compare, class Allocator, class Options> class Parallel_loader;
   template <class Iter, class NodeType> struct Node_insert_bundle;
 
+  // Comparators for which the order of two keys is decided by the first byte in which they
+  // differ (compared as unsigned char), with a prefix ordered before its extensions. For these,
+  // the order of siblings in the tree is the order of the first bytes of their edge labels.
+  template <class Compare> struct Is_lexicographic : std::false_type {};
+  template <> struct Is_lexicographic<std::less<std::string>> : std::true_type {};
+  template <> struct Is_lexicographic<std::less<>> : std::true_type {};
+
+  // Keys given as a contiguous sequence of char, e.g. std::string_view, const char* or
+  // std::vector<char>, are looked up by their bytes without constructing a key_type
+  template <class K>
+  concept Contiguous_key = std::is_convertible_v<const K&, std::string_view> ||
+      (std::ranges::contiguous_range<const K> && std::ranges::sized_range<const K> &&
+       std::is_same_v<std::ranges::range_value_t<const K>, char>);
+  template <Contiguous_key K> std::string_view KeyView(const K&) noexcept;
+
+  // Random access ranges of such keys, e.g. std::vector<std::string> or
+  // std::span<const std::string_view>, are looked up in batches, see radix::find_many.
+  // Ranges that yield keys by value, e.g. a transform view, are looked up key by key.
+  template <class R>
+  concept Key_range = std::ranges::random_access_range<const R> && std::ranges::sized_range<const R> &&
+      Contiguous_key<std::ranges::range_value_t<const R>>;
+
+  // Length of the common prefix of two byte sequences. Keys often share long prefixes, e.g.
+  // URLs or paths, so the bytes are compared in blocks of 32 (AVX2), 16 (SSE2) or 8, depending
+  // on the instruction set the code is compiled for.
+  inline size_t CommonPrefix(std::string_view, std::string_view) noexcept;
+
+  // Hint to load the cache line at the address, so that a following access does not stall
+  inline void Prefetch(const void*) noexcept;
+
+  // Calls f(i) for each i in [0, n) on the calling thread and up to threads - 1 more threads,
+  // each of which takes the next index when it is done with the last. After an exception, no
+  // more indices are started, and the first exception is rethrown once all threads are done.
+  template <class F> void ParallelFor(size_t, unsigned, F);
+
+  // Mapped type of radix_set. The elements of a radix with this mapped type are their own keys,
+  // so leaf nodes store nothing but the key.
+  struct Key_only{};
+
+  // Element type of a radix with the given mapped type and how to obtain its key
+  template <class Key, class T>
+  struct Value_traits{
+    typedef std::pair<const Key, T> value_type;
+    typedef value_type& reference;
+    typedef value_type* pointer;
+    static const Key& GetKey(const value_type& value) noexcept { return value.first; }
+  };
+
+  // Keys of a set cannot be modified in place, so only constant references are handed out
+  template <class Key>
+  struct Value_traits<Key,Key_only>{
+    typedef Key value_type;
+    typedef const value_type& reference;
+    typedef const value_type* pointer;
+    static const Key& GetKey(const value_type& value) noexcept { return value; }
+  };
+
+  // All memory of a radix, i.e. nodes, child maps and edge labels, is obtained from the
+  // allocator of the radix, rebound to the type that is allocated. Construction and
+  // destruction of the objects is left to the caller.
+  template <class U, class Alloc> U* Allocate(const Alloc&, size_t=1);
+  template <class U, class Alloc> void Deallocate(U*, const Alloc&, size_t=1) noexcept;
+
+  // Allocators declare with the member type compact_links = std::true_type, that all memory of a
+  // radix comes from one contiguous region of at most 16 GiB, aligned to link_granularity. Links
+  // between nodes are then stored as 32-bit offsets instead of pointers.
+  template <class Alloc, class=void> struct Uses_compact_links : std::false_type {};
+  template <class Alloc>
+  struct Uses_compact_links<Alloc, std::void_t<typename Alloc::compact_links>> : Alloc::compact_links {};
+
+  // Options declare with the member type leaf_links = std::true_type, that the leaves of a radix
+  // should be linked in key order, see leaf_linked.
+  template <class Options, class=void> struct Uses_leaf_links : std::false_type {};
+  template <class Options>
+  struct Uses_leaf_links<Options, std::void_t<typename Options::leaf_links>> : Options::leaf_links {};
+
+  // Options declare with the member type root_index = std::integral_constant<unsigned,N>, that a
+  // radix should index the nodes below its root by the first N bytes of their key, see
+  // root_indexed.
+  template <class Options, class=void> struct Uses_root_index : std::integral_constant<unsigned,0> {};
+  template <class Options>
+  struct Uses_root_index<Options, std::void_t<typename Options::root_index>> : Options::root_index {};
+
+  // Options declare with the member type hash_index = H, that a radix should keep a hash index of
+  // its elements that hashes their keys as std::string_view with H, see hash_indexed.
+  template <class Options, class=void> struct Uses_hash_index { typedef void type; };
+  template <class Options>
+  struct Uses_hash_index<Options, std::void_t<typename Options::hash_index>> { typedef typename Options::hash_index type; };
+
+  // Options declare with the member type lookup_cache = std::integral_constant<size_t,N>, that a
+  // radix should cache the leaves of N recently looked up keys, see lookup_cached.
+  template <class Options, class=void> struct Uses_lookup_cache : std::integral_constant<size_t,0> {};
+  template <class Options>
+  struct Uses_lookup_cache<Options, std::void_t<typename Options::lookup_cache>> : Options::lookup_cache {};
+
+  // Allocators declare with the member type concurrent_allocation = std::false_type, that their
+  // copies must not allocate or deallocate on several threads at once. Polymorphic allocators
+  // depend on their memory resource, which is not known, so they are assumed not to allow it.
+  template <class Alloc, class=void> struct Allows_concurrency : std::true_type {};
+  template <class Alloc>
+  struct Allows_concurrency<Alloc, std::void_t<typename Alloc::concurrent_allocation>> : Alloc::concurrent_allocation {};
+  template <class U>
+  struct Allows_concurrency<std::pmr::polymorphic_allocator<U>> : std::false_type {};
+
+  //////////
+  // LINK //
+  //////////
+  // Link defines how a pointer to a node is stored inside the tree. By default, links are plain
+  // pointers. Compact links are 32-bit offsets from the address at which the link is stored,
+  // rounded down to link_granularity, to the target, counted in units of link_granularity.
+  // Compact links are independent of the position of the region in memory, but must not be
+  // copied bitwise, so they are always read with Load() and written with Store().
+  // Nodes are at least 2-byte aligned, so the lowest bit of a link is free to carry a tag, which
+  // is used by a node to store whether it is a leaf in the link to its parent.
+  // A null pointer is stored as 0 (or the tag), which is never the offset to a different object.
+  constexpr size_t link_granularity = 16;
+
+  template <class NodePtr, bool Compact>
+  struct Link{
+    typedef uintptr_t type;
+    static NodePtr Load(const type&) noexcept;
+    static void Store(type&, NodePtr, bool=false) noexcept;
+    static bool Tag(const type&) noexcept;
+    static void Copy(const type*, const type*, type*) noexcept;
+    static void CopyBackward(const type*, const type*, type*) noexcept;
+  };
+
+  template <class NodePtr>
+  struct Link<NodePtr,true>{
+    typedef int32_t type;
+    static NodePtr Load(const type&) noexcept;
+    static void Store(type&, NodePtr, bool=false) noexcept;
+    static bool Tag(const type&) noexcept;
+    static void Copy(const type*, const type*, type*) noexcept;
+    static void CopyBackward(const type*, const type*, type*) noexcept;
+  };
+
+  ///////////////
+  // CHILD MAP //
+  ///////////////
+  // Child_map stores the children of a node. The edge labels of two siblings never share
+  // their first character, so children are indexed by the first byte of their edge label.
+  // In the style of the Adaptive Radix Tree, the layout adapts to the number of children:
+  //  - Node4:   up to 4 children, stored inline in the node itself
+  //  - Node16:  up to 16 children, the byte array is searched with SSE2 where available
+  //  - Node48:  up to 48 children, a 256-entry index maps each byte to a child slot
+  //  - Node256: a direct 256-entry table of children
+  // The map grows and shrinks automatically on Insert() and Erase(). Shrinking is optional, so
+  // Erase() keeps the larger layout if the smaller one cannot be allocated and never throws.
+  // In addition to the lookup structure, each layout keeps the bytes of its children in
+  // iteration order, which is the order of the edge labels under the radix' comparator.
+  // Children are therefore addressed by their position in that order, and by their byte for
+  // lookups.
+  // Child_map does not own the children, deleting them is the responsibility of Node.
+  // Layouts larger than Node4 are allocated with the allocator that is passed to the
+  // modifiers, so the map must be released with that allocator before it is destroyed.
+  // With compact links, the children are stored as 32-bit offsets, which halves the size of the
+  // larger layouts.
+  // The header of the map, i.e. the kind, the count and the bytes of Node4, takes 8 bytes and is
+  // followed by the inline children or the pointer to the larger layout. Together with the edge
+  // label and the parent link, a node without payload fits into a single 64-byte cache line.
+  template <class NodePtr, bool ByteOrdered, bool Compact=false>
+  class Child_map{
+    public:
+      Child_map() noexcept;
+      Child_map(const Child_map&) = delete;
+      Child_map& operator=(const Child_map&) = delete;
+
+      // Capacity
+      size_t size() const noexcept;
+      bool empty() const noexcept;
+
+      // Lookup by byte
+      NodePtr Find(unsigned char) const;
+      size_t Position(unsigned char) const;
+      size_t LowerPosition(unsigned char) const;
+
+      // Access by position
+      unsigned char ByteAt(size_t) const;
+      NodePtr ChildAt(size_t) const;
+      NodePtr Front() const;
+      NodePtr Back() const;
+
+      // Modifiers
+      template <class Alloc> void Insert(size_t, unsigned char, NodePtr, const Alloc&);
+      template <class Alloc> void Erase(size_t, const Alloc&) noexcept;
+      void Replace(size_t, NodePtr) noexcept;
+      template <class Alloc> void Release(const Alloc&) noexcept;
+      void swap(Child_map&) noexcept;
+
+      // Iteration over the children in order
+      class const_iterator{
+        public:
+          const_iterator(const Child_map*, size_t);
+          NodePtr operator*() const;
+          const_iterator& operator++();
+          bool operator!=(const const_iterator&) const;
+        private:
+          const Child_map* m_map;
+          size_t m_pos;
+      };
+      const_iterator begin() const;
+      const_iterator end() const;
+
+    private:
+      enum class Kind : unsigned char {node4, node16, node48, node256};
+      typedef Link<NodePtr,Compact> link;
+      typedef typename link::type link_type;
+
+      struct Node4{
+        link_type children[4];
+      };
+      struct Node16{
+        unsigned char bytes[16];
+        link_type children[16];
+      };
+      struct Node48{
+        unsigned char index[256]; // 0 if byte is unused, otherwise slot + 1
+        unsigned char order[48];
+        link_type children[48];
+      };
+      struct Node256{
+        unsigned char order[256];
+        link_type children[256];
+      };
+      union Storage{
+        Node4 node4;
+        Node16* node16;
+        Node48* node48;
+        Node256* node256;
+      };
+
+      Kind m_kind;
+      unsigned short m_count;
+      unsigned char m_inline_bytes[4]; // Bytes of Node4, which fit into the header
+      Storage m_storage;
+
+      size_t Capacity() const;
+      const unsigned char* Order() const;
+      template <class Alloc> void Rebuild(Kind, const Alloc&);
+  };
+
+  ////////////////
+  // EDGE LABEL //
+  ////////////////
+  // Edge_label stores the label of the edge between a node and its parent. Most labels are
+  // short after path compression, so labels of up to inline_capacity bytes are stored inline,
+  // which keeps them on the same cache line as the rest of the node. Longer labels either
+  // spill to an owned heap buffer (Assign), or refer to memory that outlives the label
+  // (Borrow), which is used by leaf nodes whose label is the tail of their own key.
+  // The label occupies 16 bytes: the inline bytes double as storage for the pointer of long
+  // labels, and the highest bit of the size marks a borrowed label.
+  // Heap buffers come from the allocator that is passed to Assign(), so an owned label must be
+  // released with the same allocator before it is destroyed.
+  class Edge_label{
+    public:
+      static constexpr size_t inline_capacity = 12;
+
+      Edge_label() noexcept;
+      Edge_label(const Edge_label&) = delete;
+      Edge_label& operator=(const Edge_label&) = delete;
+
+      template <class Alloc> void Assign(std::string_view, const Alloc&);
+      template <class Alloc> void Borrow(std::string_view, const Alloc&);
+      template <class Alloc> void Release(const Alloc&) noexcept;
+
+      std::string_view View() const noexcept;
+      size_t size() const noexcept;
+
+    private:
+      static constexpr uint32_t borrowed_flag = uint32_t(1) << 31;
+
+      char m_bytes[inline_capacity];
+      uint32_t m_size;
+
+      bool IsInline() const noexcept;
+      const char* HeapData() const noexcept;
+      void SetHeapData(const char*) noexcept;
+  };
+
+  ////////////////
+  // HASH INDEX //
+  ////////////////
+  // Hash_index maps the full key of each element to its leaf node, so that exact lookups do not
+  // descend the tree. It is an open addressing table: each slot holds the hash of the key and a
+  // link to the leaf, collisions are resolved by linear probing, and removals shift the following
+  // slots back instead of leaving tombstones. The table doubles before it gets more than three
+  // quarters full, which Reserve() does ahead of Insert(), so that adding a leaf that is already
+  // in the tree cannot fail. Like Child_map, the table is allocated with the allocator passed to
+  // the modifiers and must be released with it.
+  // With Hash = void, the index is disabled and holds nothing.
+  template <class NodePtr, bool Compact, class Hash>
+  class Hash_index{
+    public:
+      Hash_index() noexcept;
+      Hash_index(const Hash_index&) = delete;
+      Hash_index& operator=(const Hash_index&) = delete;
+
+      NodePtr Find(std::string_view) const;
+      template <class Alloc> void Reserve(size_t, const Alloc&);
+      void Insert(NodePtr) noexcept;
+      void Erase(NodePtr) noexcept;
+      template <class Alloc> void Release(const Alloc&) noexcept;
+      void swap(Hash_index&) noexcept;
+
+    private:
+      typedef Link<NodePtr,Compact> link;
+      struct Slot{
+        size_t hash;
+        typename link::type node;
+      };
+      static constexpr size_t min_capacity = 16;
+
+      Slot* m_slots;
+      size_t m_capacity;
+      size_t m_size;
+      [[no_unique_address]] Hash m_hasher;
+
+      void Place(size_t, NodePtr) noexcept;
+  };
+
+  template <class NodePtr, bool Compact>
+  class Hash_index<NodePtr,Compact,void>{
+    public:
+      void swap(Hash_index&) noexcept {}
+  };
+
+  //////////////////
+  // LOOKUP CACHE //
+  //////////////////
+  // Lookup_cache is a direct-mapped cache from the hash of a key to the leaf node of that key, in
+  // front of the exact-match lookups of a radix. A slot holds the hash and a link to the leaf, and
+  // a lookup is a hit if the key of the leaf equals the key. The slots are allocated with the root
+  // of the tree, and a leaf leaves the cache when it is extracted, so the cache never points to a
+  // node that is not in the tree. Lookups count their hits and misses.
+  // With Entries = 0, the cache is disabled and holds nothing.
+  template <class NodePtr, bool Compact, size_t Entries>
+  class Lookup_cache{
+    public:
+      static_assert(std::has_single_bit(Entries), "the number of cache entries must be a power of two");
+
+      Lookup_cache() noexcept;
+      Lookup_cache(const Lookup_cache&) = delete;
+      Lookup_cache& operator=(const Lookup_cache&) = delete;
+
+      static size_t Hash(std::string_view) noexcept;
+      NodePtr Find(std::string_view, size_t) noexcept;
+      void Store(size_t, NodePtr) noexcept;
+      void Erase(NodePtr) noexcept;
+      void Clear() noexcept;
+      template <class Alloc> void Allocate(const Alloc&);
+      template <class Alloc> void Release(const Alloc&) noexcept;
+      void swap(Lookup_cache&) noexcept;
+
+      size_t hits;
+      size_t misses;
+
+    private:
+      typedef Link<NodePtr,Compact> link;
+      struct Slot{
+        size_t hash;
+        typename link::type node;
+      };
+
+      Slot* m_slots;
+  };
+
+  template <class NodePtr, bool Compact>
+  class Lookup_cache<NodePtr,Compact,0>{
+    public:
+      void swap(Lookup_cache&) noexcept {}
+  };
+
   //////////
   // NODE //
   //////////
   // Node is the class that stores the key-value pair, when an element is added
   // to the radix tree. Each node represents one pair and connects to other nodes
   // via pointers. Each node has one parent and a variable number of children that
-  // are stored inside a std::map. Due to the nature of radix trees, there are
+  // are stored inside a Child_map. Due to the nature of radix trees, there are
   // nodes that do not themselves store meaningful data but only exist to link to
   // children. These are called non-leaf nodes.
+  // Node itself only holds the links within the tree. A node is either a Leaf_node,
+  // which holds the key-value pair, or an Inner_node, which is a non-leaf node and
+  // carries no mapped value. Nodes are created and deleted with the static functions
+  // NewLeaf(), NewInner() and Delete(), which dispatch on the node type.
+  // Each node stores the label of the edge that connects it to its parent only once.
+  // Non-leaf nodes store nothing but the label, their full key is the concatenation
+  // of the labels on the path from the root and is only rebuilt when needed. Leaf
+  // nodes must hold their full key as part of the value pair, so their label only
+  // refers to the tail of that key, unless it is short enough to be stored inline.
   // The node class implementation is entirely private and only accessible through
   // its friend relations. Nodes are only accessed via pointers, so the class does
   // not provide move and copy constructors/operators.
+  // All memory of a node is obtained from the allocator of the radix, which is therefore
+  // passed to every function that creates, deletes or relabels nodes.
+  // A radix that holds no tree points to the shared EmptyRoot() instead, which is never
+  // modified or deleted, so that empty instances do not allocate.
   // Node deletion follows the following rules:
-  //  - the radix instance deletes its root node
-  //  - parent nodes delete their children
+  //  - the radix instance deletes its root node, unless it is the shared empty root
+  //  - Delete() deletes the children of a node along with the node
   //  - Node_handle manages and deletes orphan nodes
-  template <class T, class Compare>
+  template <class T, class Compare, class Allocator, class Options>
   class Node{
 
     // Friends
-    friend typename radix<T,Compare>::iterator;
-    friend typename radix<T,Compare>::const_iterator;
-    friend typename radix<T,Compare>::node_type;
-    friend xsm::radix<T,Compare>;
+    friend typename radix<T,Compare,Allocator,Options>::iterator;
+    friend typename radix<T,Compare,Allocator,Options>::const_iterator;
+    friend typename radix<T,Compare,Allocator,Options>::node_type;
+    friend xsm::radix<T,Compare,Allocator,Options>;
+    friend Leaf_node<T,Compare,Allocator,Options>;
+    friend Inner_node<T,Compare,Allocator,Options>;
+    template <class, bool, class> friend class Hash_index;
+    template <class, bool, size_t> friend class Lookup_cache;
+    friend Bulk_loader<T,Compare,Allocator,Options>;
+    friend Parallel_loader<T,Compare,Allocator,Options>;
 
     // Aliases
-    using key_type = typename radix<T,Compare>::key_type;
-    using mapped_type = typename radix<T,Compare>::mapped_type;
-    using value_type = typename radix<T,Compare>::value_type;
-    using key_compare = typename radix<T,Compare>::key_compare;
-    typedef Node<T,Compare>* node_ptr;
-    typedef const Node<T,Compare>* const_node_ptr;
-    typedef std::map<key_type,node_ptr,key_compare> child_map;
+    using key_type = typename radix<T,Compare,Allocator,Options>::key_type;
+    using mapped_type = typename radix<T,Compare,Allocator,Options>::mapped_type;
+    using value_type = typename radix<T,Compare,Allocator,Options>::value_type;
+    using key_compare = typename radix<T,Compare,Allocator,Options>::key_compare;
+    using allocator_type = typename radix<T,Compare,Allocator,Options>::allocator_type;
+    typedef Node<T,Compare,Allocator,Options>* node_ptr;
+    typedef const Node<T,Compare,Allocator,Options>* const_node_ptr;
+    static constexpr bool compact_links = Uses_compact_links<allocator_type>::value;
+    typedef Link<node_ptr,compact_links> link;
+    typedef Child_map<node_ptr,Is_lexicographic<key_compare>::value,compact_links> child_map;
+    static constexpr bool leaf_links = Uses_leaf_links<Options>::value;
 
     // Members
-    value_type m_value_pair;
-    node_ptr m_parent;
+    // The edge label and the children are needed during descent and come first. Whether the
+    // node is a leaf is stored in the tag bit of the parent link, so that a non-leaf node
+    // occupies a single cache line and the value pair of a leaf starts on the next one.
+    Edge_label m_label;
     child_map m_children;
-    const bool m_is_leaf;
+    typename link::type m_parent;
 
     // Constructors and related
-    Node();
-    Node(node_ptr, value_type&&, const bool=false);
-    template <class... Args> Node(node_ptr, const bool, Args&&...);
-    ~Node();
+    explicit Node(const bool);
+
+    static node_ptr NewInner(const allocator_type&);
+    static node_ptr EmptyRoot() noexcept;
+    template <class... Args> static node_ptr NewLeaf(const allocator_type&, Args&&...);
+    static size_t Delete(node_ptr, const allocator_type&) noexcept;
 
     // Node state
     bool IsChildless() const;
@@ -96,34 +524,184 @@ namespace xsm::detail{
     void SetParent(node_ptr);
     node_ptr GetFirstChild() const;
     node_ptr GetLastDescendant();
+    node_ptr GetFirstLeaf();
     child_map& GetChildren();
     const child_map& GetChildren() const;
     const key_type& GetKey() const;
+    value_type& GetValuePair();
+    const value_type& GetValuePair() const;
+    std::string_view GetLabel() const;
+    void SetLabel(std::string_view, const allocator_type&);
+    unsigned char GetEdgeByte() const;
+
+    // Links between leaves in key order, only available with leaf_links
+    node_ptr GetPrevLeaf() const;
+    node_ptr GetNextLeaf() const;
+    void LinkLeaf(node_ptr, node_ptr);
+    void UnlinkLeaf();
+    void LinkLeaves(node_ptr, node_ptr, node_ptr);
+    void UnlinkLeaves(node_ptr);
 
     // Node ownership
-    node_ptr AddChild(const key_type&, node_ptr);
-    node_ptr AddChild(const key_type&);
-    node_ptr Extract();
-    node_ptr GiveUpChild();
-    void SubstituteWith(node_ptr);
+    node_ptr AddChild(const key_type&, node_ptr, const allocator_type&);
+    node_ptr AddChild(const key_type&, const allocator_type&);
+    node_ptr AppendChild(std::string_view, node_ptr, const allocator_type&);
+    node_ptr Extract(const allocator_type&);
+    node_ptr GiveUpChild(const allocator_type&);
+    void SubstituteWith(node_ptr, const allocator_type&);
     void RemoveParent();
-    void Adopt(node_ptr);
-    void Emancipate();
+    void Adopt(node_ptr, const key_type&, const allocator_type&);
+    void Emancipate(const allocator_type&);
+    size_t ChildPosition(const key_type&) const;
 
     // Container operations
-    node_ptr Retrieve(const key_type&);
+    node_ptr Retrieve(std::string_view);
     template <class K> node_ptr FindCondition(bool(*)(const key_type&, const K&), const K&);
     template <class K> node_ptr FindConditionNonLeaf(bool(*)(const key_type&, const K&), const K&);
+    template <bool Upper> node_ptr FindBoundNonLeaf(std::string_view, node_ptr);
 
     // Display
     void print() const; // TODO just for testing
   };
 
+  // Links of a leaf to the previous and the next leaf in key order. Null links mark the first
+  // and the last element.
+  template <class Link, bool Enabled>
+  struct Leaf_links{};
+
+  template <class Link>
+  struct Leaf_links<Link,true>{
+    typename Link::type prev;
+    typename Link::type next;
+  };
+
+  // Table of a radix with one link for each combination of the first Bytes bytes of a key. A
+  // link points to the deepest node whose key is a prefix of these bytes, or to the root. Its
+  // tag is set if the key of that node is one byte shorter than Bytes. The table is allocated
+  // together with the root node by the first insertion, and released with it by clear().
+  template <class Link, unsigned Bytes>
+  struct Root_index{
+    static_assert(Bytes == 1 || Bytes == 2, "the root index covers one or two bytes");
+    static constexpr size_t slots = size_t(1) << (8 * Bytes);
+    typename Link::type* entries = nullptr;
+  };
+
+  template <class Link>
+  struct Root_index<Link,0>{};
+
+  // Leaf node, holds the key-value pair of an element
+  template <class T, class Compare, class Allocator, class Options>
+  class Leaf_node : public Node<T,Compare,Allocator,Options>{
+    friend Node<T,Compare,Allocator,Options>;
+
+    using value_type = typename radix<T,Compare,Allocator,Options>::value_type;
+    using link = typename Node<T,Compare,Allocator,Options>::link;
+
+    [[no_unique_address]] Leaf_links<link,Node<T,Compare,Allocator,Options>::leaf_links> m_links;
+    value_type m_value_pair;
+
+    template <class... Args> Leaf_node(Args&&...);
+  };
+
+  // Non-leaf node, only links to its children and does not carry a mapped value
+  template <class T, class Compare, class Allocator, class Options>
+  class Inner_node : public Node<T,Compare,Allocator,Options>{
+    friend Node<T,Compare,Allocator,Options>;
+
+    Inner_node();
+  };
+
+  /////////////////
+  // BULK LOADER //
+  /////////////////
+  // Bulk_loader builds the subtree of a node bottom-up from leaves that are appended in ascending
+  // key order, in time linear in the total length of their keys. A node is only linked to its
+  // parent once a key leaves its subtree, until then it waits on the path to the last key. The
+  // depth of its parent is then known from the common prefixes of adjacent keys, so nodes are
+  // created with their final labels and are never split or searched for.
+  // The keys of the leaves must extend the key of the node. The loader owns the nodes that wait
+  // on the path, and deletes them if it is destroyed before Finish(). Counting and indexing the
+  // leaves is left to the radix.
+  template <class T, class Compare, class Allocator, class Options>
+  class Bulk_loader{
+    using node_ptr = typename Node<T,Compare,Allocator,Options>::node_ptr;
+
+    public:
+      Bulk_loader(node_ptr, std::string_view, const Allocator&);
+      Bulk_loader(const Bulk_loader&) = delete;
+      Bulk_loader& operator=(const Bulk_loader&) = delete;
+      ~Bulk_loader();
+
+      std::string_view LastKey() const noexcept;
+      bool Append(node_ptr);
+      void Finish();
+
+    private:
+      struct Pending{
+        node_ptr node;
+        size_t depth; // Length of the key of the node
+      };
+
+      std::vector<Pending> m_path;
+      std::string_view m_last_key;
+      Allocator m_alloc;
+
+      void LinkLast(size_t);
+  };
+
+  /////////////////////
+  // PARALLEL LOADER //
+  /////////////////////
+  // Parallel_loader builds a tree from elements in any order on several threads, see
+  // radix::insert_parallel(). The leaves are created in parallel and partitioned by the byte that
+  // follows the common prefix of their keys, in a pass that is split among the threads. The node
+  // of the common prefix is created on the way. Partitions that are small enough become tasks,
+  // which sort their leaves and build their subtree with a Bulk_loader, in parallel to each
+  // other. Larger partitions are partitioned again by the next byte in which their keys differ.
+  // The subtrees are finally linked to the nodes that the partitioning has created. As with
+  // insertions one by one, the first of several elements with the same key is kept.
+  // The loader owns the leaves and subtrees until they are linked into the tree, and deletes
+  // them if it is destroyed before Load() has returned.
+  template <class T, class Compare, class Allocator, class Options>
+  class Parallel_loader{
+    using node_ptr = typename Node<T,Compare,Allocator,Options>::node_ptr;
+
+    public:
+      Parallel_loader(const Allocator&, unsigned);
+      Parallel_loader(const Parallel_loader&) = delete;
+      Parallel_loader& operator=(const Parallel_loader&) = delete;
+      ~Parallel_loader();
+
+      template <class It> size_t Load(It, It, node_ptr);
+
+    private:
+      struct Task{
+        size_t begin;       // Range of the leaves in m_leaves
+        size_t end;
+        size_t depth;       // Length of the key of the parent, which the keys of the leaves share
+        node_ptr parent;
+        node_ptr subtree;   // Stand-in for the parent while the subtree is built
+        size_t count;       // Number of leaves in the subtree
+      };
+
+      Allocator m_alloc;
+      unsigned m_threads;
+      size_t m_grain;              // Partitions of up to this many leaves become tasks
+      node_ptr m_root;
+      std::vector<node_ptr> m_leaves; // Leaves that are not linked yet, null once they are
+      std::vector<node_ptr> m_buffer;
+      std::vector<Task> m_tasks;
+      size_t m_count;              // Number of leaves linked by the partitioning
+
+      void Partition(size_t, size_t, size_t, node_ptr, size_t);
+      void Build(Task&);
+  };
+
   // Forward declarations to allow for overloaded comparison operators
-  template <class T, class Compare, class ItType, class ItType2=ItType>
-  bool operator==(const Iterator_impl<T,Compare,ItType>&, const Iterator_impl<T,Compare,ItType2>&);
-  template <class T, class Compare, class ItType, class ItType2=ItType>
-  bool operator!=(const Iterator_impl<T,Compare,ItType>&, const Iterator_impl<T,Compare,ItType2>&);
+  template <class T, class Compare, class Allocator, class Options, class ItType, class ItType2=ItType>
+  bool operator==(const Iterator_impl<T,Compare,Allocator,Options,ItType>&, const Iterator_impl<T,Compare,Allocator,Options,ItType2>&);
+  template <class T, class Compare, class Allocator, class Options, class ItType, class ItType2=ItType>
+  bool operator!=(const Iterator_impl<T,Compare,Allocator,Options,ItType>&, const Iterator_impl<T,Compare,Allocator,Options,ItType2>&);
 
   /////////////////
   // NODE HANDLE //
@@ -132,46 +710,54 @@ namespace xsm::detail{
   // is allowed to manage and delete isolated nodes, i.e. nodes without children or a parent.
   // In this latter function it behaves like unique_ptr, where it deletes the object
   // once node handle outlives its life-time.
-  template <class T, class Compare>
+  // A non-empty node handle carries a copy of the allocator that allocated its node. It is
+  // used to delete the node and decides whether a radix can take over the node as is.
+  template <class T, class Compare, class Allocator, class Options>
   class Node_handle{
     // Friend
-    friend radix<T,Compare>;
+    friend radix<T,Compare,Allocator,Options>;
 
     public:
-      using key_type = typename radix<T,Compare>::key_type;
-      using mapped_type = typename radix<T,Compare>::mapped_type;
-      using node_ptr = typename Node<T,Compare>::node_ptr;
-      //using allocator_type // TODO
+      using key_type = typename radix<T,Compare,Allocator,Options>::key_type;
+      using mapped_type = typename radix<T,Compare,Allocator,Options>::mapped_type;
+      using value_type = typename radix<T,Compare,Allocator,Options>::value_type;
+      using node_ptr = typename Node<T,Compare,Allocator,Options>::node_ptr;
+      using allocator_type = typename radix<T,Compare,Allocator,Options>::allocator_type;
       
       constexpr Node_handle() noexcept = default;
-      Node_handle(Node_handle<T,Compare>&&) noexcept;
-      Node_handle& operator=(Node_handle<T,Compare>&&);
+      Node_handle(Node_handle<T,Compare,Allocator,Options>&&) noexcept;
+      Node_handle& operator=(Node_handle<T,Compare,Allocator,Options>&&);
       ~Node_handle();
 
       [[nodiscard]] bool empty() const noexcept;
       explicit operator bool() const noexcept;
-      //allocator_type get_allocator() const; 
+      allocator_type get_allocator() const; 
      
       const key_type& key() const;
       mapped_type& mapped() const;
+      const value_type& value() const; // For radix_set, where the value is the key
 
-      /*void swap(Node_handle&) noexcept(
+      void swap(Node_handle&) noexcept(
           std::allocator_traits<allocator_type>::propagate_on_container_swap::value ||
           std::allocator_traits<allocator_type>::is_always_equal::value);
-      */
+
+      friend void swap(Node_handle& x, Node_handle& y) noexcept(noexcept(x.swap(y))){
+        x.swap(y);
+      }
 
     private:
-      using child_map = typename Node<T,Compare>::child_map;
-      using node_type = typename radix<T,Compare>::node_type;
+      using child_map = typename Node<T,Compare,Allocator,Options>::child_map;
+      using node_type = typename radix<T,Compare,Allocator,Options>::node_type;
 
       node_ptr m_node_ptr = nullptr;
+      std::optional<allocator_type> m_alloc;
 
-      // Constructor from raw pointer
-      Node_handle(node_ptr);
+      // Constructor from raw pointer and the allocator of the node
+      Node_handle(node_ptr, const allocator_type&);
 
+      void Reset() noexcept;
+      void SetAllocator(const std::optional<allocator_type>&);
   };
-
-  //friend void swap(Node_handle& x, Node_handle& y) noexcept(noexcept(x.swap(y)));
   
   ////////////////////////
   // INSERT RETURN TYPE //
@@ -188,31 +774,35 @@ namespace xsm::detail{
   // ITERATOR //
   //////////////
   // Bidiectional iterator class
-  template <class T, class Compare, class ItType>
+  // Iterators only refer to their node, so they stay valid as long as the element exists.
+  // Stepping to the next or previous element is free of allocations and, over a full
+  // traversal, looks up each non-leaf node once in its parent.
+  template <class T, class Compare, class Allocator, class Options, class ItType>
   class Iterator_impl {
 
-    friend radix<T,Compare>;
+    friend radix<T,Compare,Allocator,Options>;
     // If ItType is T: ItType2 is const T
     // If ItType is const T: ItType2 is T
     typedef typename std::conditional<std::is_const_v<ItType>, T, const T>::type ItType2;
-    friend Iterator_impl<T,Compare,ItType2>;
-
-    using const_iterator = typename radix<T,Compare>::const_iterator;
-    using key_type = typename radix<T,Compare>::key_type;
-    using reverse_iterator = typename radix<T,Compare>::reverse_iterator;
-    using const_reverse_iterator = typename radix<T,Compare>::const_reverse_iterator;
-    using node_ptr = typename Node<T,Compare>::node_ptr;
-    using const_node_ptr = typename Node<T,Compare>::const_node_ptr;
+    friend Iterator_impl<T,Compare,Allocator,Options,ItType2>;
+
+    using const_iterator = typename radix<T,Compare,Allocator,Options>::const_iterator;
+    using key_type = typename radix<T,Compare,Allocator,Options>::key_type;
+    using reverse_iterator = typename radix<T,Compare,Allocator,Options>::reverse_iterator;
+    using const_reverse_iterator = typename radix<T,Compare,Allocator,Options>::const_reverse_iterator;
+    using node_ptr = typename Node<T,Compare,Allocator,Options>::node_ptr;
+    using const_node_ptr = typename Node<T,Compare,Allocator,Options>::const_node_ptr;
+    using child_map = typename Node<T,Compare,Allocator,Options>::child_map;
     
     public:
       // These aliases must be public for std::reverse_iterator to work
-      using value_type = typename radix<T,Compare>::value_type;
-      using difference_type = typename radix<T,Compare>::difference_type;
+      using value_type = typename radix<T,Compare,Allocator,Options>::value_type;
+      using difference_type = typename radix<T,Compare,Allocator,Options>::difference_type;
       typedef typename std::conditional<
-        std::is_const_v<ItType>, typename radix<T,Compare>::const_reference, typename radix<T,Compare>::reference
+        std::is_const_v<ItType>, typename radix<T,Compare,Allocator,Options>::const_reference, typename radix<T,Compare,Allocator,Options>::reference
         >::type reference;
       typedef typename std::conditional<
-        std::is_const_v<ItType>, typename radix<T,Compare>::const_pointer, typename radix<T,Compare>::pointer
+        std::is_const_v<ItType>, typename radix<T,Compare,Allocator,Options>::const_pointer, typename radix<T,Compare,Allocator,Options>::pointer
         >::type pointer;
 
       // Constructor
@@ -231,64 +821,266 @@ namespace xsm::detail{
       operator const_iterator() const;
       
       // Explicit instantiation for template type
-      friend bool operator== <> (const Iterator_impl<T,Compare,ItType>&, const Iterator_impl<T,Compare,ItType>&);
-      friend bool operator== <> (const Iterator_impl<T,Compare,ItType>&, const Iterator_impl<T,Compare,ItType2>&);
-      friend bool operator!= <> (const Iterator_impl<T,Compare,ItType>&, const Iterator_impl<T,Compare,ItType>&);
-      friend bool operator!= <> (const Iterator_impl<T,Compare,ItType>&, const Iterator_impl<T,Compare,ItType2>&);
+      friend bool operator== <> (const Iterator_impl<T,Compare,Allocator,Options,ItType>&, const Iterator_impl<T,Compare,Allocator,Options,ItType>&);
+      friend bool operator== <> (const Iterator_impl<T,Compare,Allocator,Options,ItType>&, const Iterator_impl<T,Compare,Allocator,Options,ItType2>&);
+      friend bool operator!= <> (const Iterator_impl<T,Compare,Allocator,Options,ItType>&, const Iterator_impl<T,Compare,Allocator,Options,ItType>&);
+      friend bool operator!= <> (const Iterator_impl<T,Compare,Allocator,Options,ItType>&, const Iterator_impl<T,Compare,Allocator,Options,ItType2>&);
+      // Mixed comparisons with the const-ness reversed need access to this class as well
+      friend bool operator== <> (const Iterator_impl<T,Compare,Allocator,Options,ItType2>&, const Iterator_impl<T,Compare,Allocator,Options,ItType>&);
+      friend bool operator!= <> (const Iterator_impl<T,Compare,Allocator,Options,ItType2>&, const Iterator_impl<T,Compare,Allocator,Options,ItType>&);
     private:
+      // Position of m_node among the children of its parent, as far as it is known. It saves
+      // looking up the node in its parent when stepping to a sibling, and is verified before
+      // use, because modifications of the tree may shift the positions.
+      static constexpr size_t unknown_position = SIZE_MAX;
+
+      // An iterator to the root stands for end(). The end() of a radix holds no node but refers to
+      // the root member of the radix instead, so that it stays valid when the root is allocated
+      // by the first insert and released by clear().
       node_ptr m_node;
+      size_t m_position;
+      const node_ptr* m_root;
 
-      Iterator_impl(node_ptr);
+      Iterator_impl(node_ptr, size_t=unknown_position);
+      static Iterator_impl End(const node_ptr&);
 
+      node_ptr GetNode() const;
+
+      size_t PositionInParent(const child_map&) const;
       bool Advance();
       bool Regress();
   };
 }
 
 namespace xsm{
+  ///////////////
+  // NODE POOL //
+  ///////////////
+  // node_pool is a memory arena for the nodes of one or more radix instances. Memory is carved
+  // from large slabs, so that inserting an element does not call malloc for every node.
+  // Blocks are grouped into size classes with a granularity of 16 bytes, and freed blocks are
+  // kept in a free list per size class for reuse. Blocks larger than max_block_size, or with a
+  // stricter alignment than the granularity, are forwarded to the global operator new.
+  // Once all blocks are returned, e.g. after radix::clear(), every slab except the most recent
+  // one is freed at once. On Linux, slabs can be backed by huge pages, which are requested
+  // explicitly and fall back to transparent huge pages if none are reserved.
+  // If a region size is given, the pool reserves one contiguous range of address space up front
+  // and takes all slabs from it, which is required by compact_pool_allocator. Physical memory is
+  // only committed on first use where the platform allows it. In a region, blocks that do not fit
+  // a size class get a slab of their own, which is only reclaimed once the pool is empty.
+  // The pool is not thread-safe and must outlive all containers that allocate from it.
+  class node_pool{
+    public:
+      static constexpr size_t default_slab_size = size_t(1) << 20;
+      static constexpr size_t huge_page_size = size_t(1) << 21;
+      static constexpr size_t granularity = 16;
+      static constexpr size_t max_block_size = 4096;
+      static constexpr size_t max_region_size = size_t(1) << 34;
+
+      explicit node_pool(size_t slab_size = default_slab_size, bool huge_pages = false, size_t region_size = 0);
+      node_pool(const node_pool&) = delete;
+      node_pool& operator=(const node_pool&) = delete;
+      ~node_pool();
+
+      void* allocate(size_t, size_t alignment = alignof(std::max_align_t));
+      void deallocate(void*, size_t, size_t alignment = alignof(std::max_align_t)) noexcept;
+      void release() noexcept;
+
+      size_t slab_count() const noexcept;
+      size_t blocks_in_use() const noexcept;
+      bool huge_pages() const noexcept;
+      bool contiguous() const noexcept;
+
+    private:
+      struct Slab{
+        Slab* next;
+        size_t size;
+        bool mapped;
+      };
+      struct Free_block{
+        Free_block* next;
+      };
+
+      static constexpr size_t class_count = max_block_size / granularity;
+      static constexpr size_t header_size = (sizeof(Slab) + granularity - 1) / granularity * granularity;
+
+      Free_block* m_free[class_count];
+      Slab* m_slabs;
+      char* m_cursor;
+      char* m_end;
+      size_t m_slab_size;
+      size_t m_slab_count;
+      size_t m_blocks_in_use;
+      bool m_huge_pages;
+      char* m_region;
+      size_t m_region_size;
+      size_t m_region_used;
+
+      static bool IsPooled(size_t, size_t) noexcept;
+      Slab* NewSlab(size_t);
+      void FreeSlab(Slab*) noexcept;
+      void Recycle() noexcept;
+  };
+
+  // Allocator that obtains its memory from a node_pool. Copies and rebound copies share the
+  // pool and compare equal, so node handles can be moved between containers using the same pool.
+  // The allocator propagates with the container, so that the pool follows the elements. Like the
+  // pool, it must not be used on several threads at once.
+  template <class T>
+  class pool_allocator{
+    template <class U> friend class pool_allocator;
+
+    public:
+      typedef T value_type;
+      typedef std::true_type propagate_on_container_copy_assignment;
+      typedef std::true_type propagate_on_container_move_assignment;
+      typedef std::true_type propagate_on_container_swap;
+      typedef std::false_type concurrent_allocation;
+
+      pool_allocator(node_pool&) noexcept;
+      template <class U> pool_allocator(const pool_allocator<U>&) noexcept;
+
+      [[nodiscard]] T* allocate(size_t);
+      void deallocate(T*, size_t) noexcept;
+
+      node_pool& pool() const noexcept;
+
+    private:
+      node_pool* m_pool;
+  };
+
+  template <class T, class U>
+  bool operator==(const pool_allocator<T>&, const pool_allocator<U>&) noexcept;
+  template <class T, class U>
+  bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&) noexcept;
+
+  // Allocator for a node_pool with a reserved region. All memory of a radix then lies within
+  // the region, so the radix links its nodes with 32-bit offsets instead of 64-bit pointers.
+  // The links do not depend on the address of the region.
+  template <class T>
+  class compact_pool_allocator : public pool_allocator<T>{
+    public:
+      typedef T value_type;
+      typedef std::true_type compact_links;
+      template <class U> struct rebind{
+        typedef compact_pool_allocator<U> other;
+      };
+
+      compact_pool_allocator(node_pool&) noexcept;
+      template <class U> compact_pool_allocator(const compact_pool_allocator<U>&) noexcept;
+  };
+
+  /////////////
+  // OPTIONS //
+  /////////////
+  // Options select structures that a radix keeps besides its tree, which cost memory and work on
+  // every update in exchange for faster lookups or scans. They are combined with radix_options
+  // and passed as the last template argument of radix, e.g.
+  //   radix<int,std::less<std::string>,std::allocator<std::pair<const std::string,int>>,radix_options<leaf_linked>>
+  // Each option declares a member type that the radix detects, see detail::Uses_leaf_links.
+  template <class... Opts>
+  struct radix_options : Opts... {};
+
+  // Links each element to the previous and the next one in key order. Iterators then step between
+  // elements by following a single link instead of walking through the non-leaf nodes, which
+  // speeds up range scans and complete(). Each element costs two links more, and every insertion
+  // looks up its neighbours once.
+  struct leaf_linked{
+    typedef std::true_type leaf_links;
+  };
+
+  // Keeps a table indexed by the first one or two bytes of a key, which points to the deepest node
+  // covering these bytes. find(), lower_bound(), complete() and insertions then skip the top
+  // levels of the tree. The table has 256 or 65536 links and is allocated with the first element,
+  // not with the radix; it is updated when nodes within the first bytes of the keys are added or
+  // removed.
+  template <unsigned Bytes = 2>
+  struct root_indexed{
+    typedef std::integral_constant<unsigned,Bytes> root_index;
+  };
+
+  // Keeps a hash index from the full key of each element to its node, in addition to the tree.
+  // find(), contains(), count(), at(), erase() and extract() by key are then answered by the hash
+  // index with one probe sequence and one key comparison, while lower_bound(), complete() and
+  // iteration use the tree. The index costs 16 bytes per slot, and insertions and removals
+  // update it. Hash is called with the key as std::string_view.
+  template <class Hash = std::hash<std::string_view>>
+  struct hash_indexed{
+    typedef Hash hash_index;
+  };
+
+  // Puts a direct-mapped cache of Entries slots in front of the exact-match lookups, i.e. find(),
+  // contains(), count(), at() and operator[]. A slot remembers the element that was last found
+  // for the keys that hash to it, so frequently requested keys are answered without a descent.
+  // radix::cache_stats() reports the hits and misses, to tune the number of entries. As lookups
+  // update the cache, const member functions of such a radix must not be called concurrently.
+  template <size_t Entries = 256>
+  struct lookup_cached{
+    typedef std::integral_constant<size_t,Entries> lookup_cache;
+  };
+
+  // Hits and misses of the lookup cache of a radix
+  struct lookup_cache_stats{
+    size_t hits;
+    size_t misses;
+  };
+
   ///////////
   // RADIX //
   ///////////
   //
-  //template <class T> operator<=>(const radix<T,Compare>, const radix<T,Compare>);
-  //template <class T, class Pred> radix<T,Compare>::size_type erase_if(radix<T,Compare>, Pred);
+  //template <class T> operator<=>(const radix<T,Compare,Allocator,Options>, const radix<T,Compare,Allocator,Options>);
+  //template <class T, class Pred> radix<T,Compare,Allocator,Options>::size_type erase_if(radix<T,Compare,Allocator,Options>, Pred);
   //
   // Publicly accessible container class
-  template <class T, class Compare=std::less<std::string>> class radix{
+  template <class T, class Compare=std::less<std::string>, class Allocator=std::allocator<std::pair<const std::string,T>>,
+            class Options=radix_options<>> class radix{
     public:
       // Aliases
       typedef std::string key_type;
       typedef T mapped_type;
-      typedef std::pair<const key_type, mapped_type> value_type;
+      typedef typename detail::Value_traits<key_type,mapped_type>::value_type value_type;
       typedef std::size_t size_type;
       typedef std::ptrdiff_t difference_type;
       typedef Compare key_compare;
-      typedef value_type& reference;
+      typedef Allocator allocator_type;
+      typedef typename detail::Value_traits<key_type,mapped_type>::reference reference;
       typedef const value_type& const_reference;
-      typedef value_type* pointer;
+      typedef typename detail::Value_traits<key_type,mapped_type>::pointer pointer;
       typedef const value_type* const_pointer;
-      typedef detail::Iterator_impl<mapped_type,key_compare> iterator;
-      typedef detail::Iterator_impl<mapped_type,key_compare,const mapped_type> const_iterator;
+      typedef detail::Iterator_impl<mapped_type,key_compare,allocator_type,Options> iterator;
+      typedef detail::Iterator_impl<mapped_type,key_compare,allocator_type,Options,const mapped_type> const_iterator;
       typedef std::pair<iterator,iterator> iterator_pair;
       typedef std::pair<const_iterator,const_iterator> const_iterator_pair;
       typedef std::reverse_iterator<iterator> reverse_iterator;
       typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
-      typedef detail::Node_handle<mapped_type,key_compare> node_type;
+      typedef detail::Node_handle<mapped_type,key_compare,allocator_type,Options> node_type;
       typedef detail::Node_insert_bundle<iterator,node_type> insert_return_type;
 
+      static_assert(std::is_same_v<typename allocator_type::value_type, value_type>,
+          "radix::allocator_type must allocate radix::value_type");
+
       // Constructors and related
-      radix();
+      radix() noexcept(noexcept(allocator_type()));
+      explicit radix(const allocator_type&) noexcept;
       radix(const radix&);
+      radix(const radix&, const allocator_type&);
       radix(radix&&) noexcept;
+      radix(radix&&, const allocator_type&);
       ~radix();
-      radix(std::initializer_list<value_type>);
+      radix(std::initializer_list<value_type>, const allocator_type& = allocator_type());
+      template <class InputIt> radix(InputIt, InputIt, const allocator_type& = allocator_type());
 
-      radix<T,Compare>& operator=(const radix<T,Compare>&);
-      radix<T,Compare>& operator=(radix<T,Compare>&&) noexcept;
+      radix<T,Compare,Allocator,Options>& operator=(const radix<T,Compare,Allocator,Options>&);
+      radix<T,Compare,Allocator,Options>& operator=(radix<T,Compare,Allocator,Options>&&) noexcept(
+          std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value ||
+          std::allocator_traits<allocator_type>::is_always_equal::value);
 
       // Special
       template <class K> iterator_pair complete(const K&);
       template <class K> const_iterator_pair complete(const K&) const;
+      template <detail::Contiguous_key K> iterator_pair complete(const_iterator, const K&);
+      template <detail::Contiguous_key K> const_iterator_pair complete(const_iterator, const K&) const;
 
       // Capacity
       [[nodiscard]] bool empty() const noexcept;
@@ -300,10 +1092,11 @@ namespace xsm{
       template <class P> std::pair<iterator, bool> insert(P&&);
       std::pair<iterator,bool> insert(value_type&&);
       iterator insert(const_iterator, const value_type&);
-      template <class P> iterator insert(const_iterator, P&&);
+      template <class P> requires std::is_constructible_v<value_type,P&&> iterator insert(const_iterator, P&&);
       iterator insert(const_iterator, value_type&&);
       template <class InputIt> void insert(InputIt, InputIt);
       void insert(std::initializer_list<value_type>);
+      template <std::random_access_iterator It> void insert_parallel(It, It, unsigned = 0);
       insert_return_type insert(node_type&&);
       iterator insert(const_iterator, node_type&&);
       // template< class M > std::pair<iterator, bool> insert_or_assign( const Key& k, M&& obj );
@@ -320,17 +1113,26 @@ namespace xsm{
       iterator erase(const_iterator);
       iterator erase(const_iterator, const_iterator);
       size_type erase(const key_type&); 
-      //template <class K> size_type erase(K&&); c++23
-      void swap(radix<T,Compare>&);
+      template <detail::Contiguous_key K> size_type erase(const K&);
+      size_type erase_prefix(const key_type&);
+      template <detail::Contiguous_key K> size_type erase_prefix(const K&);
+      void swap(radix<T,Compare,Allocator,Options>&) noexcept;
       node_type extract(const_iterator);
       node_type extract(const key_type&);
-      //void merge(radix<T,Compare>&);
-      //void merge(radix<T,Compare>&&);
+      template <detail::Contiguous_key K> node_type extract(const K&);
+      void merge(radix<T,Compare,Allocator,Options>&);
+      void merge(radix<T,Compare,Allocator,Options>&&);
+      radix extract_prefix(const key_type&);
+      template <detail::Contiguous_key K> radix extract_prefix(const K&);
+      radix split(const key_type&);
+      template <detail::Contiguous_key K> radix split(const K&);
       void clear();
 
       // Element access
       mapped_type& at(const key_type&);
       const mapped_type& at(const key_type&) const;
+      template <detail::Contiguous_key K> mapped_type& at(const K&);
+      template <detail::Contiguous_key K> const mapped_type& at(const K&) const;
       mapped_type& operator[](const key_type&);
       //mapped_type& operator[](key_type&&);
 
@@ -343,6 +1145,11 @@ namespace xsm{
       const_iterator find(const key_type&) const;
       template <class K> iterator find(const K&);
       template <class K> const_iterator find(const K&) const;
+      template <detail::Contiguous_key K> iterator find(const_iterator, const K&);
+      template <detail::Contiguous_key K> const_iterator find(const_iterator, const K&) const;
+      template <detail::Key_range R> void find_many(const R&, std::span<iterator>);
+      template <detail::Key_range R> void find_many(const R&, std::span<const_iterator>) const;
+      template <detail::Key_range R> void contains_many(const R&, std::span<bool>) const;
       iterator_pair equal_range(const key_type&);
       const_iterator_pair equal_range(const key_type&) const;
       template <class K> iterator_pair equal_range(const K&);
@@ -351,6 +1158,8 @@ namespace xsm{
       const_iterator lower_bound(const key_type&) const;
       template <class K> iterator lower_bound(const K&);
       template <class K> const_iterator lower_bound(const K&) const;
+      template <detail::Contiguous_key K> iterator lower_bound(const_iterator, const K&);
+      template <detail::Contiguous_key K> const_iterator lower_bound(const_iterator, const K&) const;
       iterator upper_bound(const key_type&);
       const_iterator upper_bound(const key_type&) const;
       template <class K> iterator upper_bound(const K&);
@@ -359,7 +1168,9 @@ namespace xsm{
       // Observers
       // key_compare key_comp() const;
       // std::map::value_compare value_comp() const;
-      // allocator_type get_allocator() const noexcept;
+      allocator_type get_allocator() const noexcept;
+      lookup_cache_stats cache_stats() const noexcept requires (detail::Uses_lookup_cache<Options>::value != 0);
+      void reset_cache_stats() noexcept requires (detail::Uses_lookup_cache<Options>::value != 0);
 
       // Iterator
       iterator begin() noexcept;
@@ -380,18 +1191,87 @@ namespace xsm{
       void print() const;
 
     private:
-      using node_ptr = typename detail::Node<mapped_type,key_compare>::node_ptr;
-      using const_node_ptr = typename detail::Node<mapped_type,key_compare>::const_node_ptr;
-      
-      node_ptr m_root; // Pointer to root node of radix tree
-      size_type m_size;
-
+      using node_ptr = typename detail::Node<mapped_type,key_compare,allocator_type,Options>::node_ptr;
+      using const_node_ptr = typename detail::Node<mapped_type,key_compare,allocator_type,Options>::const_node_ptr;
+      using value_traits = detail::Value_traits<key_type,mapped_type>;
+      using link = typename detail::Node<mapped_type,key_compare,allocator_type,Options>::link;
+      static constexpr unsigned root_index_bytes = detail::Uses_root_index<Options>::value;
+      using hasher = typename detail::Uses_hash_index<Options>::type;
+      using hash_index = detail::Hash_index<node_ptr,detail::Node<mapped_type,key_compare,allocator_type,Options>::compact_links,hasher>;
+      static constexpr size_t lookup_cache_entries = detail::Uses_lookup_cache<Options>::value;
+      using lookup_cache = detail::Lookup_cache<node_ptr,detail::Node<mapped_type,key_compare,allocator_type,Options>::compact_links,lookup_cache_entries>;
+
+      // Node on the path of a cut, the length of its key and the positions of its children that move
+      struct Cut_level{
+        node_ptr node;
+        size_t depth;
+        size_t first;
+        size_t last;
+      };
+
+      [[no_unique_address]] allocator_type m_alloc;
+      node_ptr m_root; // Pointer to root node of radix tree, or the shared empty root
+      size_type m_size; // Number of elements
+      [[no_unique_address]] detail::Root_index<link,root_index_bytes> m_index;
+      [[no_unique_address]] hash_index m_hash_index;
+      [[no_unique_address]] mutable lookup_cache m_cache;
+
+      node_ptr Lookup(std::string_view) const;
+      node_ptr FindLeaf(std::string_view) const;
+      template <class R, class Visit> void LookupMany(const R&, Visit) const;
+      node_ptr EnsureRoot();
+      template <class InputIt> node_ptr BulkLoad(InputIt&, InputIt);
+      node_ptr IndexedStart(std::string_view&) const;
+      node_ptr Finger(node_ptr, std::string_view&) const;
+      node_ptr FingerBound(node_ptr, std::string_view) const;
+      node_ptr SubtreeEnd(node_ptr) const;
+      node_ptr FindPrefix(std::string_view, size_t&) const;
+      void UpdateIndex(unsigned char);
+      void Register(node_ptr);
+      void LinkToNeighbours(node_ptr, node_ptr) noexcept;
+      void DeleteTree() noexcept;
+      size_type EraseSubtree(node_ptr) noexcept;
+      void EraseHashed(node_ptr) noexcept;
+      void Prune(node_ptr) noexcept;
+      void TakeTree(radix&) noexcept;
+      node_type Rehome(node_type&&);
       key_type::const_iterator ProcessHint(const_iterator&, node_ptr);
       std::pair<iterator,bool> NodeInTree(node_type&&, const_iterator, key_type::const_iterator);
-
+      void MergeChildren(node_ptr, node_ptr, radix&, size_type&);
+      node_ptr MergeChild(node_ptr, node_ptr, size_t, radix&, size_type&);
+      node_ptr MergeNode(node_ptr, node_ptr, radix&, size_type&);
+      node_ptr SplitEdge(node_ptr, size_t);
+      void Transplant(node_ptr, node_ptr, std::string_view, radix&);
+      node_ptr TakeLeaf(node_ptr, node_ptr, radix&);
+      void MoveHashed(node_ptr, radix&) noexcept;
+      void Cut(const std::vector<Cut_level>&, std::string_view, radix&);
+      static size_type CountLeaves(node_ptr) noexcept;
+      template <class Function> static void ForEachLeaf(node_ptr, Function) noexcept;
+
+      template <bool Upper, class K> node_ptr FindBound(const K&) const;
       template <class K> static bool conditionLower(const key_type&, const K&);
       template <class K> static bool conditionUpper(const key_type&, const K&);
   };
+
+  ///////////////
+  // RADIX SET //
+  ///////////////
+  // Set of strings on the same tree as radix. Leaf nodes hold only the key, iterators and node
+  // handles give constant access to it. The members that refer to the mapped value, i.e. at(),
+  // operator[] and node_type::mapped(), are not available.
+  template <class Compare=std::less<std::string>, class Allocator=std::allocator<std::string>, class Options=radix_options<>>
+  using radix_set = radix<detail::Key_only,Compare,Allocator,Options>;
+}
+
+namespace xsm::pmr{
+  // radix whose nodes, edge labels and child maps are all allocated from a single
+  // std::pmr::memory_resource. Node handles can be moved between instances on the same
+  // resource without copying the element.
+  template <class T, class Compare=std::less<std::string>, class Options=radix_options<>>
+  using radix = xsm::radix<T,Compare,std::pmr::polymorphic_allocator<std::pair<const std::string,T>>,Options>;
+
+  template <class Compare=std::less<std::string>, class Options=radix_options<>>
+  using radix_set = xsm::radix<detail::Key_only,Compare,std::pmr::polymorphic_allocator<std::string>,Options>;
 }
  
 /////////////////
@@ -402,768 +1282,3329 @@ namespace xsm{
 #include <utility>
 
 namespace xsm{
-  ///////////
-  // RADIX //
-  ///////////
-  // Constructor
-  template <class T, class Compare>
-  radix<T,Compare>::radix() : m_root(new detail::Node<T,Compare>()), m_size(0) {}
+  ///////////////
+  // NODE POOL //
+  ///////////////
+  inline node_pool::node_pool(size_t slab_size, bool huge_pages, size_t region_size)
+    : m_free(),
+      m_slabs(nullptr),
+      m_cursor(nullptr),
+      m_end(nullptr),
+      m_slab_size(std::max(slab_size, header_size + max_block_size)),
+      m_slab_count(0),
+      m_blocks_in_use(0),
+      m_huge_pages(huge_pages),
+      m_region(nullptr),
+      m_region_size(0),
+      m_region_used(0) {
+#if !defined(__linux__)
+    // Huge pages are only supported on Linux
+    m_huge_pages = false;
+#endif
+    // Huge pages can only be mapped in multiples of their size
+    if (m_huge_pages){
+      m_slab_size = (m_slab_size + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
 
-  // Constructor from initaliser list
-  template <class T, class Compare>
-  radix<T,Compare>::radix(std::initializer_list<typename radix<T,Compare>::value_type> init) : 
-    m_root(new detail::Node<T,Compare>()), m_size(0){
-    insert(init);
-  }
-  
-  // Copy constructor
-  template <class T, class Compare>
-  radix<T,Compare>::radix(const radix& rdx){
-    m_root = new detail::Node<T,Compare>();
-    for (auto it = rdx.begin(); it != rdx.end(); ++it){
-      emplace(it->first, it->second);
+    if (region_size){
+      m_region_size = std::min(std::max(region_size, m_slab_size), max_region_size);
+#if defined(__linux__)
+      // Reserve address space only, pages are committed when they are touched
+      void* region = mmap(nullptr, m_region_size, PROT_READ | PROT_WRITE, 
+          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+      if (region == MAP_FAILED){
+        throw std::bad_alloc();
+      }
+      if (m_huge_pages){
+        madvise(region, m_region_size, MADV_HUGEPAGE);
+      }
+      m_region = static_cast<char*>(region);
+#else
+      m_region = static_cast<char*>(::operator new(m_region_size, std::align_val_t(granularity)));
+#endif
     }
-    m_size = rdx.size();
   }
 
-  // Move constructor
-  template <class T, class Compare>
-  radix<T,Compare>::radix(radix&& rdx) noexcept {
-    m_root = rdx.m_root;
-    m_size = rdx.size();
-    rdx.m_root = new detail::Node<T,Compare>();
-    rdx.m_size = 0;
-  }
-  
-  // Destructor
-  template <class T, class Compare>
-  radix<T,Compare>::~radix(){
-    delete m_root;
-  }
-  
-  // Copy assignment
-  template <class T, class Compare>
-  radix<T,Compare>& radix<T,Compare>::operator=(const radix<T,Compare>& rdx){
-    radix<T,Compare> cpy = rdx;
-    this->swap(cpy);
-    return *this;
+  inline node_pool::~node_pool(){
+    release();
+    if (m_region){
+#if defined(__linux__)
+      munmap(m_region, m_region_size);
+#else
+      ::operator delete(m_region, m_region_size, std::align_val_t(granularity));
+#endif
+    }
   }
 
-  // Move assignment
-  template <class T, class Compare>
-  radix<T,Compare>& radix<T,Compare>::operator=(radix<T,Compare>&& rdx) noexcept {
-    delete m_root;
-    m_root = rdx.m_root;
-    m_size = rdx.m_size;
-    rdx.m_root = new detail::Node<T,Compare>();
-    rdx.m_size = 0;
-    return *this;
+  // Blocks that do not fit a size class are not taken from the slabs
+  inline bool node_pool::IsPooled(size_t bytes, size_t alignment) noexcept {
+    return bytes <= max_block_size && alignment <= granularity;
   }
 
-  //////////////
-  // COMPLETE //
-  //////////////
-  // The two return iterators are the begin and end iterators for the set of
-  // all descendants of the input key
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::iterator_pair radix<T,Compare>::complete(const K& key){
-    
-    node_ptr b_node = m_root->FindConditionNonLeaf(radix::conditionLower<K>, key);
-    iterator e_it(b_node->GetLastDescendant());
-    ++e_it;
-
-    iterator b_it(b_node);
-    if (!b_node->IsLeaf()){
-      ++b_it;
+  inline void* node_pool::allocate(size_t bytes, size_t alignment){
+    if (!IsPooled(bytes, alignment)){
+      if (!m_region){
+        return ::operator new(bytes, std::align_val_t(alignment));
+      }
+      // Must not leave the region, so the block gets a slab of its own
+      Slab* slab = NewSlab(header_size + bytes + alignment);
+      void* block = reinterpret_cast<char*>(slab) + header_size;
+      size_t space = slab->size - header_size;
+      ++m_blocks_in_use;
+      return std::align(alignment, bytes, block, space);
     }
 
-    return std::make_pair(b_it, e_it);
+    const size_t size_class = (std::max(bytes, size_t(1)) + granularity - 1) / granularity - 1;
+    void* block;
+    if (m_free[size_class]){
+      block = m_free[size_class];
+      m_free[size_class] = m_free[size_class]->next;
+    }
+    else {
+      const size_t block_size = (size_class + 1) * granularity;
+      if (static_cast<size_t>(m_end - m_cursor) < block_size){
+        Slab* slab = NewSlab(m_slab_size);
+        m_cursor = reinterpret_cast<char*>(slab) + header_size;
+        m_end = reinterpret_cast<char*>(slab) + slab->size;
+      }
+      block = m_cursor;
+      m_cursor += block_size;
+    }
+    ++m_blocks_in_use;
+    return block;
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::const_iterator_pair radix<T,Compare>::complete(const K& key) const {
-    
-    node_ptr b_node = m_root->FindConditionNonLeaf(radix::conditionLower<K>, key);
-    const_iterator e_it(b_node->GetLastDescendant());
-    ++e_it;
-
-    const_iterator b_it(b_node);
-    if (!b_node->IsLeaf()){
-      ++b_it;
+  inline void node_pool::deallocate(void* block, size_t bytes, size_t alignment) noexcept {
+    if (!IsPooled(bytes, alignment)){
+      if (!m_region){
+        ::operator delete(block, bytes, std::align_val_t(alignment));
+        return;
+      }
+    }
+    else {
+      const size_t size_class = (std::max(bytes, size_t(1)) + granularity - 1) / granularity - 1;
+      Free_block* free_block = static_cast<Free_block*>(block);
+      free_block->next = m_free[size_class];
+      m_free[size_class] = free_block;
     }
 
-    return std::make_pair(b_it, e_it);
-  }
-
-  template <class T, class Compare>
-  [[nodiscard]] bool radix<T,Compare>::empty() const noexcept {
-    return begin() == end();
-  }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::size_type radix<T,Compare>::size() const noexcept {
-    return m_size;
+    if (--m_blocks_in_use == 0){
+      Recycle();
+    }
   }
 
-  template <class T, class Compare>
-  std::pair<detail::Iterator_impl<T,Compare>,bool> radix<T,Compare>::insert(const value_type& key_value){ 
-    return emplace(std::move(key_value));
-  }
-  
-  template <class T, class Compare> template <class P>
-  std::pair<detail::Iterator_impl<T,Compare>,bool> radix<T,Compare>::insert(P&& value){
-    return emplace(std::forward<P>(value));
+  // Frees all slabs. No block of the pool may be in use.
+  inline void node_pool::release() noexcept {
+    assert(!m_blocks_in_use);
+    while (m_slabs){
+      Slab* next = m_slabs->next;
+      FreeSlab(m_slabs);
+      m_slabs = next;
+    }
+#if defined(__linux__)
+    // Return the pages of the region to the system, the address space stays reserved
+    if (m_region && m_region_used){
+      madvise(m_region, m_region_used, MADV_DONTNEED);
+    }
+#endif
+    std::fill(std::begin(m_free), std::end(m_free), nullptr);
+    m_cursor = m_end = nullptr;
+    m_slab_count = 0;
+    m_region_used = 0;
   }
 
-  template <class T, class Compare>
-  std::pair<detail::Iterator_impl<T,Compare>,bool> radix<T,Compare>::insert(value_type&& key_value){ 
-    return emplace(std::forward<value_type>(key_value));
+  inline size_t node_pool::slab_count() const noexcept {
+    return m_slab_count;
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::insert(const_iterator pos, const value_type& key_value){
-    return emplace_hint(pos, key_value);
+  inline size_t node_pool::blocks_in_use() const noexcept {
+    return m_blocks_in_use;
   }
 
-  template <class T, class Compare> template <class P> 
-  typename radix<T,Compare>::iterator radix<T,Compare>::insert(const_iterator pos, P&& value){
-    return emplace_hint(pos, std::forward<P>(value));
+  inline bool node_pool::huge_pages() const noexcept {
+    return m_huge_pages;
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::insert(const_iterator pos, value_type&& key_value){
-    return emplace_hint(pos, std::forward<value_type>(key_value));
-  }
-  
-  template <class T, class Compare> template <class InputIt>
-  void radix<T,Compare>::insert(InputIt it, InputIt end){
-    while (it != end){
-      insert(*it);
-      ++it;
-    }
+  inline bool node_pool::contiguous() const noexcept {
+    return m_region;
   }
 
-  template <class T, class Compare>
-  void radix<T,Compare>::insert(std::initializer_list<value_type> init_list){
-    for (auto e : init_list){
-      insert(e);
+  inline node_pool::Slab* node_pool::NewSlab(size_t size){
+    void* memory = nullptr;
+    bool mapped = false;
+    if (m_region){
+      size = (size + granularity - 1) / granularity * granularity;
+      if (size > m_region_size - m_region_used){
+        throw std::bad_alloc();
+      }
+      memory = m_region + m_region_used;
+      m_region_used += size;
     }
-  }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::insert_return_type radix<T,Compare>::insert(node_type&& node){
-    insert_return_type retval;
-    if (node.empty()){
-      retval.inserted = false;
-      retval.node = std::move(node);
-      retval.position = end();
+#if defined(__linux__)
+    else if (m_huge_pages){
+      // Reserved huge pages are preferred, otherwise ask for transparent huge pages
+      size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+      memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (memory == MAP_FAILED){
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED){
+          throw std::bad_alloc();
+        }
+        madvise(memory, size, MADV_HUGEPAGE);
+      }
+      mapped = true;
     }
+#endif
     else {
-      std::tie(retval.position,retval.inserted) 
-        = NodeInTree(std::move(node), iterator(m_root), node.m_node_ptr->GetKey().begin());
-      retval.node = std::move(node);
-      if (retval.inserted) {
-        retval.node = node_type();
-      }
+      memory = ::operator new(size, std::align_val_t(granularity));
     }
-    return retval;
+
+    Slab* slab = ::new (memory) Slab{m_slabs, size, mapped};
+    m_slabs = slab;
+    ++m_slab_count;
+    return slab;
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::insert(const_iterator pos, node_type&& node){
-    if (node.empty()){
-      return end();
+  // Slabs in a region are reclaimed together with the region
+  inline void node_pool::FreeSlab(Slab* slab) noexcept {
+    if (m_region){
+      return;
     }
-    iterator it;
-    std::tie(it,std::ignore) = NodeInTree(std::move(node), pos, ProcessHint(pos,node.m_node_ptr));
-    // Move assignment
-    node = node_type();
-    return it;
+#if defined(__linux__)
+    if (slab->mapped){
+      munmap(slab, slab->size);
+      return;
+    }
+#endif
+    ::operator delete(static_cast<void*>(slab), slab->size, std::align_val_t(granularity));
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::key_type::const_iterator radix<T,Compare>::ProcessHint(const_iterator& parent, node_ptr node){
-    
-    auto key_start = node->GetKey().begin();
-    auto key_end = node->GetKey().end();
+  // Called once no block is in use anymore. All slabs but the most recent one are freed, and
+  // the remaining slab is reused from its start. A region is reused from its start.
+  inline void node_pool::Recycle() noexcept {
+    std::fill(std::begin(m_free), std::end(m_free), nullptr);
+    if (m_region){
+      m_slabs = nullptr;
+      m_cursor = m_end = nullptr;
+      m_slab_count = 0;
+      m_region_used = 0;
+      return;
+    }
 
-    bool correct_parent_found = false;
+    Slab* slab = m_slabs->next;
+    while (slab){
+      Slab* next = slab->next;
+      FreeSlab(slab);
+      slab = next;
+    }
+    m_slabs->next = nullptr;
+    m_slab_count = 1;
+    m_cursor = reinterpret_cast<char*>(m_slabs) + header_size;
+    m_end = reinterpret_cast<char*>(m_slabs) + m_slabs->size;
+  }
 
-    while(!correct_parent_found){
+  ////////////////////
+  // POOL ALLOCATOR //
+  ////////////////////
+  template <class T>
+  pool_allocator<T>::pool_allocator(node_pool& pool) noexcept : m_pool(&pool) {}
 
-      auto parentkey_start = parent.m_node->GetKey().begin();
-      auto parentkey_end = parent.m_node->GetKey().end();
-  
-      auto last_match = std::mismatch(parentkey_start, parentkey_end, key_start, key_end);
+  template <class T> template <class U>
+  pool_allocator<T>::pool_allocator(const pool_allocator<U>& other) noexcept : m_pool(other.m_pool) {}
 
-      // Check if parent's key is a prefix of node's key
-      correct_parent_found = last_match.first == parentkey_end;
-  
-      if (!correct_parent_found){
-        // Go up one parent
-        parent = iterator(parent.m_node->GetParent());
-      }
-      else {
-        // Node should become a descendent of parent (not necessarily direct child)
-        key_start = last_match.second;
-      }
-    }
-    return key_start;
+  template <class T>
+  T* pool_allocator<T>::allocate(size_t n){
+    return static_cast<T*>(m_pool->allocate(n * sizeof(T), alignof(T)));
   }
 
-  template <class T, class Compare>
-  std::pair<typename radix<T,Compare>::iterator,bool> radix<T,Compare>::NodeInTree(
-      node_type&& nh, const_iterator parent, key_type::const_iterator key_start){
+  template <class T>
+  void pool_allocator<T>::deallocate(T* ptr, size_t n) noexcept {
+    m_pool->deallocate(ptr, n * sizeof(T), alignof(T));
+  }
 
-    auto key_end = nh.key().end();
+  template <class T>
+  node_pool& pool_allocator<T>::pool() const noexcept {
+    return *m_pool;
+  }
 
-    bool next_child;
-    // This loop only repeats if we descend one level in the tree
-    do {
-      next_child = false;
+  template <class T, class U>
+  bool operator==(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept {
+    return &lhs.pool() == &rhs.pool();
+  }
 
-      // Loop through all children in iterator, until you find a match within the keys
-      for (const std::pair<const key_type,node_ptr>& entry : parent.m_node->GetChildren()){
+  template <class T, class U>
+  bool operator!=(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept {
+    return !(lhs == rhs);
+  }
 
-        auto entrykey_start = entry.first.begin();
-        auto entrykey_end = entry.first.end();
-        auto last_match = std::mismatch(key_start, key_end, entrykey_start, entrykey_end);
-        
-        // 1. Complete mismatch -> Check next child
-        if (key_start == last_match.first){continue;}
+  template <class T>
+  compact_pool_allocator<T>::compact_pool_allocator(node_pool& pool) noexcept : pool_allocator<T>(pool) {
+    assert(pool.contiguous());
+    static_assert(node_pool::granularity % detail::link_granularity == 0);
+  }
 
-        // 2. New key and entry key are identical -> Key already exists, or leads to a non-leaf node
-        if (key_end == last_match.first && entrykey_end == last_match.second){
+  template <class T> template <class U>
+  compact_pool_allocator<T>::compact_pool_allocator(const compact_pool_allocator<U>& other) noexcept 
+    : pool_allocator<T>(other) {}
+
+  ///////////
+  // RADIX //
+  ///////////
+  // Constructor
+  // The root node is only allocated with the first element, so empty instances are free
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix() noexcept(noexcept(allocator_type())) : radix(allocator_type()) {}
+
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix(const allocator_type& alloc) noexcept : 
+    m_alloc(alloc), m_root(detail::Node<T,Compare,Allocator,Options>::EmptyRoot()), m_size(0) {}
+
+  // Constructor from initaliser list
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix(std::initializer_list<typename radix<T,Compare,Allocator,Options>::value_type> init,
+      const allocator_type& alloc) : radix(alloc){
+    insert(init);
+  }
+
+  // Constructor from a range of elements, which is built bottom-up if it is sorted
+  template <class T, class Compare, class Allocator, class Options> template <class InputIt>
+  radix<T,Compare,Allocator,Options>::radix(InputIt first, InputIt last, const allocator_type& alloc) : radix(alloc){
+    insert(first, last);
+  }
+  
+  // Copy constructor
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix(const radix& rdx) : 
+    radix(rdx, std::allocator_traits<allocator_type>::select_on_container_copy_construction(rdx.m_alloc)) {}
+
+  // The elements of a radix are sorted, so the copy is built bottom-up
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix(const radix& rdx, const allocator_type& alloc) : radix(alloc){
+    insert(rdx.begin(), rdx.end());
+  }
+
+  // Move constructor
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix(radix&& rdx) noexcept : m_alloc(rdx.m_alloc) {
+    m_root = rdx.m_root;
+    m_size = rdx.m_size;
+    m_index = rdx.m_index;
+    m_hash_index.swap(rdx.m_hash_index);
+    m_cache.swap(rdx.m_cache);
+    rdx.m_root = detail::Node<T,Compare,Allocator,Options>::EmptyRoot();
+    rdx.m_size = 0;
+    rdx.m_index = {};
+  }
+
+  // Nodes can only be taken over if they were allocated by an equal allocator, otherwise the
+  // elements are moved one by one
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::radix(radix&& rdx, const allocator_type& alloc) : radix(alloc){
+    if (m_alloc == rdx.m_alloc){
+      TakeTree(rdx);
+    }
+    else {
+      for (auto it = rdx.begin(); it != rdx.end(); ++it){
+        emplace(std::move(*it));
+      }
+      rdx.clear();
+    }
+  }
+  
+  // Destructor
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>::~radix(){
+    DeleteTree();
+  }
+  
+  // Copy assignment
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>& radix<T,Compare,Allocator,Options>::operator=(const radix<T,Compare,Allocator,Options>& rdx){
+    if (this == &rdx){
+      return *this;
+    }
+    constexpr bool propagate = std::allocator_traits<allocator_type>::propagate_on_container_copy_assignment::value;
+    radix<T,Compare,Allocator,Options> cpy(rdx, propagate? rdx.m_alloc : m_alloc);
+    if constexpr (propagate){
+      // The old tree must be deleted with the old allocator
+      clear();
+      m_alloc = rdx.m_alloc;
+    }
+    TakeTree(cpy);
+    return *this;
+  }
+
+  // Move assignment
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options>& radix<T,Compare,Allocator,Options>::operator=(radix<T,Compare,Allocator,Options>&& rdx) noexcept(
+      std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value ||
+      std::allocator_traits<allocator_type>::is_always_equal::value){
+    if (this == &rdx){
+      return *this;
+    }
+    if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value){
+      clear();
+      m_alloc = rdx.m_alloc;
+      TakeTree(rdx);
+    }
+    else if (m_alloc == rdx.m_alloc){
+      TakeTree(rdx);
+    }
+    else {
+      clear();
+      for (auto it = rdx.begin(); it != rdx.end(); ++it){
+        emplace(std::move(*it));
+      }
+      rdx.clear();
+    }
+    return *this;
+  }
+
+  // Takes over the nodes of a radix that uses an equal allocator, leaving it empty
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::TakeTree(radix& rdx) noexcept {
+    DeleteTree();
+    m_root = rdx.m_root;
+    m_size = rdx.m_size;
+    m_index = rdx.m_index;
+    m_hash_index.swap(rdx.m_hash_index);
+    m_cache.swap(rdx.m_cache);
+    rdx.m_root = detail::Node<T,Compare,Allocator,Options>::EmptyRoot();
+    rdx.m_size = 0;
+    rdx.m_index = {};
+  }
+
+  // Counts a leaf that has just been linked into the tree. With leaf links, the leaf is also
+  // linked to its neighbours, which are found by walking the tree.
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::Register(node_ptr leaf){
+    ++m_size;
+    if constexpr (!std::is_void_v<hasher>){
+      m_hash_index.Insert(leaf);
+    }
+    if constexpr (root_index_bytes){
+      // Only the leaf, its parent and their children have changed. The index can only link to them
+      // if the key of the parent is not longer than the indexed bytes.
+      const key_type& key = leaf->GetKey();
+      if (key.size() - leaf->GetLabel().size() <= root_index_bytes){
+        UpdateIndex(key.front());
+      }
+    }
+    if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+      LinkToNeighbours(leaf, leaf);
+    }
+  }
+
+  // Links the leaves from the first to the last, which are consecutive in the tree and already
+  // linked to each other, to the leaves before and after them, which are found by walking the tree
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::LinkToNeighbours(node_ptr first, node_ptr last) noexcept {
+    iterator prev(first), next(last);
+    while (prev.Regress() && prev.m_node->GetParent()) {}
+    while (next.Advance()) {}
+    first->LinkLeaves(last, prev.m_node->IsLeaf()? prev.m_node : nullptr, next.m_node->IsLeaf()? next.m_node : nullptr);
+  }
+
+  // Returns the root node to which elements can be added, allocating it if necessary. The root
+  // index and the lookup cache are allocated along with the root, all links of the root index
+  // point to the root at first. The hash index makes room for one more element, so that
+  // registering it cannot fail.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::EnsureRoot(){
+    if constexpr (!std::is_void_v<hasher>){
+      m_hash_index.Reserve(m_size + 1, m_alloc);
+    }
+    if (m_root == detail::Node<T,Compare,Allocator,Options>::EmptyRoot()){
+      if constexpr (lookup_cache_entries != 0){
+        m_cache.Allocate(m_alloc);
+      }
+      node_ptr root = detail::Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+      if constexpr (root_index_bytes){
+        typedef detail::Root_index<link,root_index_bytes> root_index;
+        try {
+          m_index.entries = detail::Allocate<typename link::type>(m_alloc, root_index::slots);
+        }
+        catch (...) {
+          detail::Node<T,Compare,Allocator,Options>::Delete(root, m_alloc);
+          throw;
+        }
+        for (size_t slot = 0; slot < root_index::slots; ++slot){
+          link::Store(m_index.entries[slot], root);
+        }
+      }
+      m_root = root;
+    }
+    return m_root;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::DeleteTree() noexcept {
+    if (m_root != detail::Node<T,Compare,Allocator,Options>::EmptyRoot()){
+      detail::Node<T,Compare,Allocator,Options>::Delete(m_root, m_alloc);
+      m_root = detail::Node<T,Compare,Allocator,Options>::EmptyRoot();
+      if constexpr (root_index_bytes){
+        detail::Deallocate(m_index.entries, m_alloc, detail::Root_index<link,root_index_bytes>::slots);
+        m_index.entries = nullptr;
+      }
+    }
+    if constexpr (!std::is_void_v<hasher>){
+      m_hash_index.Release(m_alloc);
+    }
+    if constexpr (lookup_cache_entries != 0){
+      m_cache.Release(m_alloc);
+    }
+    m_size = 0;
+  }
+
+  // Detaches a node other than the root from its parent and deletes it with its subtree, as well as
+  // the ancestors that are left without children. Returns the number of deleted elements. The
+  // root index and the lookup cache are left to the caller.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::EraseSubtree(node_ptr node) noexcept {
+    if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+      node->GetFirstLeaf()->UnlinkLeaves(node->GetLastDescendant());
+    }
+    if constexpr (!std::is_void_v<hasher>){
+      EraseHashed(node);
+    }
+    node_ptr parent = node->GetParent();
+    auto& siblings = parent->GetChildren();
+    siblings.Erase(siblings.Position(node->GetEdgeByte()), m_alloc);
+    size_type count = detail::Node<T,Compare,Allocator,Options>::Delete(node, m_alloc);
+    Prune(parent);
+    m_size -= count;
+    return count;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::EraseHashed(node_ptr node) noexcept {
+    ForEachLeaf(node, [&](node_ptr leaf){ m_hash_index.Erase(leaf); });
+  }
+
+  // Deletes a non-leaf node without children, and then its ancestors as long as they are left in
+  // the same state. The root stays.
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::Prune(node_ptr node) noexcept {
+    while (node != m_root && !node->IsLeaf() && node->IsChildless()){
+      node_ptr parent = node->GetParent();
+      auto& siblings = parent->GetChildren();
+      siblings.Erase(siblings.Position(node->GetEdgeByte()), m_alloc);
+      detail::Node<T,Compare,Allocator,Options>::Delete(node, m_alloc);
+      node = parent;
+    }
+  }
+
+  // Node at which a descent along the key starts. With a root index, this is the deepest node
+  // whose key is a prefix of the first bytes of the key, and its key is removed from the key.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::IndexedStart(std::string_view& key) const {
+    if constexpr (root_index_bytes){
+      if (m_index.entries && key.size() >= root_index_bytes){
+        size_t slot = static_cast<unsigned char>(key[0]);
+        if constexpr (root_index_bytes == 2){
+          slot = (slot << 8) | static_cast<unsigned char>(key[1]);
+        }
+        const typename link::type& entry = m_index.entries[slot];
+        node_ptr node = link::Load(entry);
+        if (node != m_root){
+          key.remove_prefix(root_index_bytes - link::Tag(entry));
+        }
+        return node;
+      }
+    }
+    return m_root;
+  }
+
+  // First node after the subtree of a node in key order, i.e. the next sibling of the node or of
+  // its closest ancestor that has one. The root stands for the end of the radix.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::SubtreeEnd(node_ptr node) const {
+    while (node != m_root){
+      node_ptr parent = node->GetParent();
+      const auto& siblings = parent->GetChildren();
+      size_t pos = siblings.Position(node->GetEdgeByte()) + 1;
+      if (pos < siblings.size()){
+        return siblings.ChildAt(pos);
+      }
+      node = parent;
+    }
+    return m_root;
+  }
+
+  // Highest node whose key starts with the prefix, which is not empty, or nullptr if there is
+  // none. The length of the key of its parent is stored in depth.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::FindPrefix(std::string_view prefix, size_t& depth) const {
+    node_ptr parent = m_root;
+    depth = 0;
+    while (true){
+      node_ptr child = parent->GetChildren().Find(prefix[depth]);
+      if (!child){
+        return nullptr;
+      }
+      std::string_view label = child->GetLabel();
+      size_t common_length = detail::CommonPrefix(label, prefix.substr(depth));
+      if (depth + common_length == prefix.size()){
+        return child;
+      }
+      if (common_length < label.size()){
+        return nullptr;
+      }
+      parent = child;
+      depth += label.size();
+    }
+  }
+
+  // Recomputes the links of the root index for keys that start with the byte. Only the child of
+  // the root with that byte and, with two bytes, its children can be linked.
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::UpdateIndex(unsigned char byte){
+    typename link::type* row = m_index.entries + (size_t(byte) << (8 * (root_index_bytes - 1)));
+    node_ptr child = m_root->GetChildren().Find(byte);
+    std::string_view label = child? child->GetLabel() : std::string_view();
+
+    if constexpr (root_index_bytes == 1){
+      link::Store(row[0], label.size() == 1? child : m_root);
+    }
+    else {
+      // Keys whose second byte leads nowhere deeper start at the child if its label is one byte
+      node_ptr shallow = label.size() == 1? child : m_root;
+      for (size_t slot = 0; slot < 256; ++slot){
+        link::Store(row[slot], shallow, shallow != m_root);
+      }
+      if (label.size() == 2){
+        link::Store(row[static_cast<unsigned char>(label[1])], child);
+      }
+      else if (label.size() == 1){
+        for (node_ptr grandchild : child->GetChildren()){
+          if (grandchild->GetLabel().size() == 1){
+            link::Store(row[grandchild->GetEdgeByte()], grandchild);
+          }
+        }
+      }
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::allocator_type radix<T,Compare,Allocator,Options>::get_allocator() const noexcept {
+    return m_alloc;
+  }
+
+  // Hits and misses of the lookup cache since construction or the last reset
+  template <class T, class Compare, class Allocator, class Options>
+  lookup_cache_stats radix<T,Compare,Allocator,Options>::cache_stats() const noexcept
+      requires (detail::Uses_lookup_cache<Options>::value != 0) {
+    return lookup_cache_stats{m_cache.hits, m_cache.misses};
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::reset_cache_stats() noexcept
+      requires (detail::Uses_lookup_cache<Options>::value != 0) {
+    m_cache.hits = 0;
+    m_cache.misses = 0;
+  }
+
+  //////////////
+  // COMPLETE //
+  //////////////
+  // The two return iterators are the begin and end iterators for the set of
+  // all descendants of the input key
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::iterator_pair radix<T,Compare,Allocator,Options>::complete(const K& key){
+    
+    node_ptr b_node = FindBound<false>(key);
+    iterator e_it(b_node->GetLastDescendant());
+    ++e_it;
+
+    iterator b_it(b_node);
+    if (!b_node->IsLeaf()){
+      ++b_it;
+    }
+
+    return std::make_pair(b_it, e_it);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator_pair radix<T,Compare,Allocator,Options>::complete(const K& key) const {
+    
+    node_ptr b_node = FindBound<false>(key);
+    const_iterator e_it(b_node->GetLastDescendant());
+    ++e_it;
+
+    const_iterator b_it(b_node);
+    if (!b_node->IsLeaf()){
+      ++b_it;
+    }
+
+    return std::make_pair(b_it, e_it);
+  }
+
+  // complete() that starts the search from a hint, see lower_bound(const_iterator, const K&)
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::iterator_pair radix<T,Compare,Allocator,Options>::complete(const_iterator hint, const K& key){
+
+    node_ptr b_node = FingerBound(hint.GetNode(), detail::KeyView(key));
+    iterator e_it(b_node->GetLastDescendant());
+    ++e_it;
+
+    iterator b_it(b_node);
+    if (!b_node->IsLeaf()){
+      ++b_it;
+    }
+
+    return std::make_pair(b_it, e_it);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator_pair radix<T,Compare,Allocator,Options>::complete(const_iterator hint, const K& key) const {
+
+    node_ptr b_node = FingerBound(hint.GetNode(), detail::KeyView(key));
+    const_iterator e_it(b_node->GetLastDescendant());
+    ++e_it;
+
+    const_iterator b_it(b_node);
+    if (!b_node->IsLeaf()){
+      ++b_it;
+    }
+
+    return std::make_pair(b_it, e_it);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  [[nodiscard]] bool radix<T,Compare,Allocator,Options>::empty() const noexcept {
+    return begin() == end();
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::size() const noexcept {
+    return m_size;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  std::pair<detail::Iterator_impl<T,Compare,Allocator,Options>,bool> radix<T,Compare,Allocator,Options>::insert(const value_type& key_value){ 
+    return emplace(std::move(key_value));
+  }
+  
+  template <class T, class Compare, class Allocator, class Options> template <class P>
+  std::pair<detail::Iterator_impl<T,Compare,Allocator,Options>,bool> radix<T,Compare,Allocator,Options>::insert(P&& value){
+    return emplace(std::forward<P>(value));
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  std::pair<detail::Iterator_impl<T,Compare,Allocator,Options>,bool> radix<T,Compare,Allocator,Options>::insert(value_type&& key_value){ 
+    return emplace(std::forward<value_type>(key_value));
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::insert(const_iterator pos, const value_type& key_value){
+    return emplace_hint(pos, key_value);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class P> requires std::is_constructible_v<typename radix<T,Compare,Allocator,Options>::value_type,P&&>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::insert(const_iterator pos, P&& value){
+    return emplace_hint(pos, std::forward<P>(value));
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::insert(const_iterator pos, value_type&& key_value){
+    return emplace_hint(pos, std::forward<value_type>(key_value));
+  }
+  
+  // Into an empty radix, elements in ascending key order are loaded bottom-up, see BulkLoad().
+  // The rest of the range from the first element that is out of order is inserted one by one.
+  template <class T, class Compare, class Allocator, class Options> template <class InputIt>
+  void radix<T,Compare,Allocator,Options>::insert(InputIt it, InputIt end){
+    if constexpr (detail::Is_lexicographic<Compare>::value){
+      if (m_size == 0 && it != end){
+        if (node_ptr leaf = BulkLoad(it, end)){
+          insert(node_type(leaf, m_alloc));
+          ++it;
+        }
+      }
+    }
+    while (it != end){
+      insert(*it);
+      ++it;
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::insert(std::initializer_list<value_type> init_list){
+    insert(init_list.begin(), init_list.end());
+  }
+
+  // Loads the elements of an empty radix with a Bulk_loader, as long as they come in ascending
+  // key order. Reads until the end of the range or until an element is out of order, whose leaf
+  // is returned. It is not in the tree yet and the iterator still points to its element.
+  // Elements with the empty key or a duplicate key are dropped, like by insert(). If an
+  // exception is thrown, the radix is left empty.
+  template <class T, class Compare, class Allocator, class Options> template <class InputIt>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::BulkLoad(InputIt& it, InputIt end){
+    node_ptr leaf = nullptr;
+    try {
+      detail::Bulk_loader<T,Compare,Allocator,Options> loader(EnsureRoot(), std::string_view(), m_alloc);
+      node_ptr last = nullptr;
+      for (; it != end; ++it){
+        if constexpr (!std::is_void_v<hasher>){
+          m_hash_index.Reserve(m_size + 1, m_alloc);
+        }
+        leaf = detail::Node<T,Compare,Allocator,Options>::NewLeaf(m_alloc, *it);
+        if (std::string_view(leaf->GetKey()) == loader.LastKey()){
+          detail::Node<T,Compare,Allocator,Options>::Delete(leaf, m_alloc);
+          leaf = nullptr;
+          continue;
+        }
+        if (!loader.Append(leaf)){
+          break;
+        }
+
+        ++m_size;
+        if constexpr (!std::is_void_v<hasher>){
+          m_hash_index.Insert(leaf);
+        }
+        if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+          leaf->LinkLeaf(last, nullptr);
+        }
+        last = leaf;
+        leaf = nullptr;
+      }
+      loader.Finish();
+    }
+    catch (...) {
+      if (leaf){
+        detail::Node<T,Compare,Allocator,Options>::Delete(leaf, m_alloc);
+      }
+      DeleteTree();
+      throw;
+    }
+
+    if constexpr (root_index_bytes){
+      for (node_ptr child : m_root->GetChildren()){
+        UpdateIndex(child->GetEdgeByte());
+      }
+    }
+    return leaf;
+  }
+
+  // Builds the tree of an empty radix from elements in any order, on the calling thread and up
+  // to threads - 1 more, by default one thread per core, see Parallel_loader. The result is the
+  // same as of insert(first, last). With allocators that cannot be used on several threads at
+  // once, e.g. pool_allocator, the tree is built on the calling thread. If the radix is not
+  // empty or its comparator is not the byte order, the elements are inserted one by one.
+  // If an exception is thrown while building, the radix is left empty.
+  template <class T, class Compare, class Allocator, class Options> template <std::random_access_iterator It>
+  void radix<T,Compare,Allocator,Options>::insert_parallel(It first, It last, unsigned threads){
+    if constexpr (detail::Is_lexicographic<Compare>::value){
+      if (m_size == 0 && first != last){
+        if constexpr (!detail::Allows_concurrency<allocator_type>::value){
+          threads = 1;
+        }
+        else if (threads == 0){
+          threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        try {
+          if constexpr (!std::is_void_v<hasher>){
+            m_hash_index.Reserve(static_cast<size_t>(last - first), m_alloc);
+          }
+          detail::Parallel_loader<T,Compare,Allocator,Options> loader(m_alloc, threads);
+          m_size = loader.Load(first, last, EnsureRoot());
+        }
+        catch (...) {
+          DeleteTree();
+          throw;
+        }
+
+        if constexpr (!std::is_void_v<hasher> || detail::Node<T,Compare,Allocator,Options>::leaf_links){
+          node_ptr prev = nullptr;
+          for (iterator it = begin(); it != end(); ++it){
+            if constexpr (!std::is_void_v<hasher>){
+              m_hash_index.Insert(it.m_node);
+            }
+            if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+              it.m_node->LinkLeaf(prev, nullptr);
+            }
+            prev = it.m_node;
+          }
+        }
+        if constexpr (root_index_bytes){
+          for (node_ptr child : m_root->GetChildren()){
+            UpdateIndex(child->GetEdgeByte());
+          }
+        }
+        return;
+      }
+    }
+    insert(first, last);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::insert_return_type radix<T,Compare,Allocator,Options>::insert(node_type&& node){
+    insert_return_type retval;
+    if (node.empty()){
+      retval.inserted = false;
+      retval.node = std::move(node);
+      retval.position = end();
+    }
+    else {
+      EnsureRoot();
+      node_type own = Rehome(std::move(node));
+      std::string_view key = own.m_node_ptr->GetKey();
+      node_ptr start = IndexedStart(key);
+      std::tie(retval.position,retval.inserted) 
+        = NodeInTree(std::move(own), iterator(start), own.m_node_ptr->GetKey().end() - key.size());
+      if (!retval.inserted) {
+        retval.node = std::move(own);
+      }
+    }
+    return retval;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::insert(const_iterator pos, node_type&& node){
+    if (node.empty()){
+      return end();
+    }
+    // A hint into an empty radix does not point into its tree
+    if (m_root == detail::Node<T,Compare,Allocator,Options>::EmptyRoot()){
+      return insert(std::move(node)).position;
+    }
+    EnsureRoot();
+    node_type own = Rehome(std::move(node));
+    iterator it;
+    std::tie(it,std::ignore) = NodeInTree(std::move(own), pos, ProcessHint(pos,own.m_node_ptr));
+    return it;
+  }
+
+  // A node handle can only be linked into the tree if its node was allocated by an allocator
+  // equal to the one of this radix. Otherwise, the element is moved into a new node.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_type radix<T,Compare,Allocator,Options>::Rehome(node_type&& node){
+    if (*node.m_alloc == m_alloc){
+      return std::move(node);
+    }
+    node_ptr rehomed = detail::Node<T,Compare,Allocator,Options>::NewLeaf(m_alloc, std::move(node.m_node_ptr->GetValuePair()));
+    node = node_type();
+    return node_type(rehomed, m_alloc);
+  }
+
+  // Finds the closest ancestor of the hint whose key is a prefix of the node's key. The hint
+  // must point to an element or to the root. Returns the position in the node's key from
+  // which on the node is a descendant of the updated hint.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::key_type::const_iterator radix<T,Compare,Allocator,Options>::ProcessHint(const_iterator& parent, node_ptr node){
+    std::string_view key = node->GetKey();
+    parent = iterator(Finger(parent.GetNode(), key));
+
+    // Node should become a descendent of parent (not necessarily direct child)
+    return node->GetKey().end() - key.size();
+  }
+
+  // Lowest ancestor of the hint whose key is a prefix of the key, and the key is shortened by
+  // the key of that ancestor. The hint must be an element or the root. A search that starts at
+  // the returned node only descends below the common prefix of the hint and the key.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::Finger(node_ptr hint, std::string_view& key) const {
+    if (!hint->GetParent()){
+      return IndexedStart(key);
+    }
+
+    // Only leaf nodes know their full key, the keys of their ancestors are prefixes thereof
+    const key_type& hint_key = hint->GetKey();
+    size_t common_length = detail::CommonPrefix(hint_key, key);
+    size_t depth = hint_key.size();
+
+    // Go up until the key of the node is a prefix of the key
+    while (depth > common_length){
+      depth -= hint->GetLabel().size();
+      hint = hint->GetParent();
+    }
+    if (!hint->GetParent()){
+      return IndexedStart(key);
+    }
+    key.remove_prefix(depth);
+    return hint;
+  }
+
+  // Lower bound of the key that climbs from the hint instead of descending from the root. Finger
+  // search relies on the byte order of the keys, other comparators search from the root.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::FingerBound(node_ptr hint, std::string_view key) const {
+    if constexpr (detail::Is_lexicographic<Compare>::value){
+      node_ptr start = Finger(hint, key);
+      return start->template FindBoundNonLeaf<false>(key, SubtreeEnd(start));
+    }
+    else {
+      return FindBound<false>(key_type(key));
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  std::pair<typename radix<T,Compare,Allocator,Options>::iterator,bool> radix<T,Compare,Allocator,Options>::NodeInTree(
+      node_type&& nh, const_iterator parent, key_type::const_iterator key_start){
+
+    auto key_end = nh.key().end();
+
+    bool next_child;
+    // This loop only repeats if we descend one level in the tree
+    do {
+      next_child = false;
+
+      // 0. The parent node already represents the whole key
+      if (key_start == key_end){
+        if (parent.m_node->IsLeaf()){
+          return std::make_pair(iterator(parent.m_node), false);
+        }
+        if (!parent.m_node->GetParent()){
+          // The empty key cannot be stored, because it is represented by the root node
+          return std::make_pair(end(), false);
+        }
+        node_type non_leaf_handle(parent.m_node, m_alloc);
+        non_leaf_handle.m_node_ptr->SubstituteWith(nh.m_node_ptr, m_alloc);
+
+        Register(nh.m_node_ptr);
+        return std::make_pair(iterator(nh.m_node_ptr), true);
+      }
+
+      // Only the child whose edge label starts with the same byte can share a prefix
+      node_ptr entry = parent.m_node->GetChildren().Find(*key_start);
+      if (entry){
+
+        std::string_view entrykey = entry->GetLabel();
+        auto entrykey_start = entrykey.begin();
+        auto entrykey_end = entrykey.end();
+        size_t common_length = detail::CommonPrefix(std::string_view(key_start, key_end), entrykey);
+        auto last_match = std::make_pair(key_start + common_length, entrykey_start + common_length);
+
+        // 1. New key and entry key are identical -> Key already exists, or leads to a non-leaf node
+        if (key_end == last_match.first && entrykey_end == last_match.second){
           
-          if (!entry.second->IsLeaf()){
+          if (!entry->IsLeaf()){
             // Unlink non-leaf node and substitute with leaf node
-           
-            // Need to copy the pointer, because entry.second will be changed by SubstituteWith()
-            node_type non_leaf_handle(entry.second);
-            non_leaf_handle.m_node_ptr->SubstituteWith(nh.m_node_ptr);
+            node_type non_leaf_handle(entry, m_alloc);
+            non_leaf_handle.m_node_ptr->SubstituteWith(nh.m_node_ptr, m_alloc);
+
+            Register(nh.m_node_ptr);
+            return std::make_pair(iterator(nh.m_node_ptr), true);
+          }
+          else {
+            // Insertion unsuccessful, return iterator to existing element
+            return std::make_pair(iterator(entry), false);
+          }
+        }
+
+        // 2. One key is prefix of the other -> The prefix key becomes the parent of the other entry
+        else if (key_end == last_match.first || entrykey_end == last_match.second){
+          // New keyword is prefix of the existing nodekey
+          if (key_end == last_match.first){
+            // Remove old node from current node, the new node takes its place
+            entry->Emancipate(m_alloc);
+            // Add a new node with the prefix to the current node
+            parent.m_node->AddChild(key_type(key_start, key_end), nh.m_node_ptr, m_alloc);
+            // Old child node becomes child of the new node
+            nh.m_node_ptr->AddChild(key_type(last_match.second, entrykey_end), entry, m_alloc);
+
+            Register(nh.m_node_ptr);
+            return std::make_pair(iterator(nh.m_node_ptr),true);
+          }
+          else {
+            // Insert new keyword as child of its prefix
+            key_start = last_match.first;
+            parent = iterator(entry);
+            next_child = true;
+          }
+        }
+
+        // 3. Words partially match but diverge
+        // -> A new node needs to be created whose key is the common prefix of the words.
+        // This node has two children, one representing the new key, the other representing the
+        // entry key
+        else {
+          // Remove old entry from current node, the common prefix takes its place
+          entry->Emancipate(m_alloc);
+          // New parent
+          node_ptr parent_ptr = parent.m_node->AddChild(key_type(key_start, last_match.first), m_alloc);
+          // Old entry
+          parent_ptr->AddChild(key_type(last_match.second,entrykey_end), entry, m_alloc);
+          // New entry
+          parent_ptr->AddChild(key_type(last_match.first,key_end), nh.m_node_ptr, m_alloc);
+
+          Register(nh.m_node_ptr);
+          return std::make_pair(iterator(nh.m_node_ptr),true);
+        }
+      }
+    } while (next_child);
+    
+    // 4. No common prefix has been found in any children -> keyword becomes a new entry
+    parent.m_node->AddChild(key_type(key_start, key_end), nh.m_node_ptr, m_alloc);
+    Register(nh.m_node_ptr);
+    return std::make_pair(iterator(nh.m_node_ptr), true);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options> template <class... Args>
+  std::pair<detail::Iterator_impl<T,Compare,Allocator,Options>,bool> radix<T,Compare,Allocator,Options>::emplace(Args&&... args){
+    
+    EnsureRoot();
+    node_ptr node = detail::Node<T,Compare,Allocator,Options>::NewLeaf(m_alloc, std::forward<Args>(args)...);
+    std::string_view key = node->GetKey();
+    node_ptr start = IndexedStart(key);
+    return NodeInTree(node_type(node, m_alloc), iterator(start), node->GetKey().end() - key.size());
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class... Args>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::emplace_hint(const_iterator pos, Args&&... args){
+    
+    // A hint into an empty radix does not point into its tree
+    if (m_root == detail::Node<T,Compare,Allocator,Options>::EmptyRoot()){
+      return emplace(std::forward<Args>(args)...).first;
+    }
+    EnsureRoot();
+    node_ptr node = detail::Node<T,Compare,Allocator,Options>::NewLeaf(m_alloc, std::forward<Args>(args)...);
+
+    // The element preceding the hint is the best starting point. If there is none, start at root.
+    const_iterator parent = (pos == cbegin())? cend() : --pos;
+    key_type::const_iterator key_start = ProcessHint(parent, node);
+
+    return NodeInTree(node_type(node, m_alloc), parent, key_start).first;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::erase(iterator it){
+    return erase(const_iterator(it));
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::erase(const_iterator it){
+    // Passing and iterator that equals end() will result in an error (Seg fault)
+    // This is the same behaviour as in std::map, so there is no need to check for
+    // this case.
+    auto ret_it = it;
+    ++ret_it;
+    extract(it);
+    return iterator(ret_it.m_node);
+  }
+
+  // Erases the elements from the first to the last position. Each subtree that starts at the first
+  // position and ends before the last is detached and deleted as a whole. Only the elements whose
+  // subtrees hold the last position are erased one by one, these are on its path.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::erase(const_iterator first, const_iterator last){
+    auto holds_last = [&last](node_ptr node){
+      for (node_ptr ancestor = last.GetNode(); ancestor; ancestor = ancestor->GetParent()){
+        if (ancestor == node){
+          return true;
+        }
+      }
+      return false;
+    };
+
+    bool touched[256] = {};
+    bool detached = false;
+    while (first != last){
+      node_ptr node = first.m_node;
+      if (holds_last(node)){
+        first = erase(first);
+        continue;
+      }
+      if constexpr (root_index_bytes){
+        touched[static_cast<unsigned char>(node->GetKey().front())] = true;
+      }
+      // A non-leaf parent whose first child is the node starts at the same position
+      for (node_ptr parent = node->GetParent(); parent != m_root && !parent->IsLeaf() &&
+          parent->GetChildren().Front() == node && !holds_last(parent); parent = node->GetParent()){
+        node = parent;
+      }
+      first = const_iterator(SubtreeEnd(node)->GetFirstLeaf());
+      EraseSubtree(node);
+      detached = true;
+    }
+
+    if (detached){
+      if constexpr (root_index_bytes){
+        for (size_t byte = 0; byte < 256; ++byte){
+          if (touched[byte]){
+            UpdateIndex(static_cast<unsigned char>(byte));
+          }
+        }
+      }
+      if constexpr (lookup_cache_entries != 0){
+        m_cache.Clear();
+      }
+    }
+    return (last == cend())? end() : iterator(last.m_node);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::erase(const key_type& key){
+    return erase<key_type>(key);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::erase(const K& key){
+    node_ptr node = Lookup(detail::KeyView(key));
+    if (!node){
+      return 0;
+    }
+    extract(const_iterator(node));
+    return 1;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::erase_prefix(const key_type& prefix){
+    return erase_prefix<key_type>(prefix);
+  }
+
+  // Erases the elements whose keys start with the prefix, and returns their number. They are all
+  // below a single node, which is detached and deleted together with its subtree.
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::erase_prefix(const K& prefix){
+    std::string_view key = detail::KeyView(prefix);
+    if (key.empty()){
+      size_type count = size();
+      clear();
+      return count;
+    }
+    size_t depth;
+    node_ptr node = FindPrefix(key, depth);
+    if (!node){
+      return 0;
+    }
+    size_type count = EraseSubtree(node);
+    if constexpr (root_index_bytes){
+      UpdateIndex(key.front());
+    }
+    if constexpr (lookup_cache_entries != 0){
+      m_cache.Clear();
+    }
+    return count;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::swap(radix<T,Compare,Allocator,Options>& rdx) noexcept {
+    // Allocators are only exchanged if they propagate, otherwise they must be equal
+    if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_swap::value){
+      std::swap(m_alloc, rdx.m_alloc);
+    }
+    // swap m_root
+    {
+      node_ptr temp = m_root;
+      m_root = rdx.m_root;
+      rdx.m_root = temp;
+    }
+    // swap m_size
+    {
+      size_t temp = m_size;
+      m_size = rdx.m_size;
+      rdx.m_size = temp;
+    }
+    // The indexes and the cache belong to the tree
+    std::swap(m_index, rdx.m_index);
+    m_hash_index.swap(rdx.m_hash_index);
+    m_cache.swap(rdx.m_cache);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_type radix<T,Compare,Allocator,Options>::extract(const_iterator it){
+
+    // Extract() also deletes the ancestors that are left without children. The nodes that change
+    // are below the parent of the highest one, which the root index may link to.
+    bool update_index = false;
+    if constexpr (root_index_bytes){
+      const node_ptr leaf = it.m_node;
+      size_t depth = leaf->GetKey().size() - leaf->GetLabel().size();
+      if (leaf->IsChildless()){
+        for (node_ptr parent = leaf->GetParent(); depth > root_index_bytes && parent->GetParent() &&
+            !parent->IsLeaf() && parent->CountChildren() == 1; parent = parent->GetParent()){
+          depth -= parent->GetLabel().size();
+        }
+      }
+      update_index = depth <= root_index_bytes;
+    }
+
+    if constexpr (!std::is_void_v<hasher>){
+      m_hash_index.Erase(it.m_node);
+    }
+    if constexpr (lookup_cache_entries != 0){
+      m_cache.Erase(it.m_node);
+    }
+    node_ptr extracted = it.m_node->Extract(m_alloc);
+    if constexpr (root_index_bytes){
+      if (update_index){
+        UpdateIndex(extracted->GetKey().front());
+      }
+    }
+
+    // Decrementing the counter causes an issue when the iterator doesn't point to an element in this radix
+    // but this is the same behaviour as in std::map
+    --m_size;
+
+    return node_type(extracted, m_alloc);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_type radix<T,Compare,Allocator,Options>::extract(const key_type& key){
+    return extract<key_type>(key);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::node_type radix<T,Compare,Allocator,Options>::extract(const K& key){
+    node_ptr node = Lookup(detail::KeyView(key));
+    return node? extract(const_iterator(node)) : node_type();
+  }
+
+  // Moves the elements of the other radix whose keys are not in this radix, like
+  // std::map::merge. The nodes are relinked and not copied. Both trees are descended together,
+  // and each subtree of the other radix whose key leads nowhere in this radix is moved as a
+  // whole, so the cost depends on the overlap of the trees, not on the number of moved
+  // elements. Only the hash index needs every moved element to be moved between the indexes.
+  // If the allocators are not equal, the elements are moved into new nodes one by one.
+  // If an exception is thrown, both trees hold all elements, some of which may have moved.
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::merge(radix<T,Compare,Allocator,Options>& rdx){
+    if (this == &rdx || rdx.m_size == 0){
+      return;
+    }
+    if (m_alloc != rdx.m_alloc){
+      for (auto it = rdx.begin(); it != rdx.end();){
+        const_iterator source = it++;
+        if (!contains(value_traits::GetKey(*source))){
+          insert(rdx.extract(source));
+        }
+      }
+      return;
+    }
+
+    EnsureRoot();
+    if constexpr (!std::is_void_v<hasher>){
+      m_hash_index.Reserve(m_size + rdx.m_size, m_alloc);
+    }
+
+    // Everything that changes is below the children of the roots with the bytes of the other
+    // root's children
+    unsigned char bytes[256];
+    size_t byte_count = 0;
+    for (node_ptr child : rdx.m_root->GetChildren()){
+      bytes[byte_count++] = child->GetEdgeByte();
+    }
+
+    std::exception_ptr error;
+    size_type kept = 0;
+    try {
+      MergeChildren(m_root, rdx.m_root, rdx, kept);
+      m_size += rdx.m_size - kept;
+      rdx.m_size = kept;
+    }
+    catch (...) {
+      // The trees are consistent, but it is not known how many elements have moved
+      error = std::current_exception();
+      m_size = static_cast<size_type>(std::distance(begin(), end()));
+      rdx.m_size = static_cast<size_type>(std::distance(rdx.begin(), rdx.end()));
+    }
+
+    if constexpr (root_index_bytes){
+      for (size_t i = 0; i < byte_count; ++i){
+        UpdateIndex(bytes[i]);
+        rdx.UpdateIndex(bytes[i]);
+      }
+    }
+    if constexpr (lookup_cache_entries != 0){
+      rdx.m_cache.Clear();
+    }
+    if (error){
+      std::rethrow_exception(error);
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::merge(radix<T,Compare,Allocator,Options>&& rdx){
+    merge(rdx);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options> radix<T,Compare,Allocator,Options>::extract_prefix(const key_type& prefix){
+    return extract_prefix<key_type>(prefix);
+  }
+
+  // Moves the elements whose keys start with the prefix into a new radix and returns it. All of
+  // them are below a single node, which is detached from this tree along with its subtree. No
+  // element is copied or relinked, only the nodes of the subtree are visited once to count the
+  // moved elements and, with a hash index, to move them to the index of the new radix. Iterators
+  // to the moved elements remain valid and refer to the new radix. If an exception is thrown,
+  // this radix is unchanged.
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  radix<T,Compare,Allocator,Options> radix<T,Compare,Allocator,Options>::extract_prefix(const K& prefix){
+    std::string_view key = detail::KeyView(prefix);
+    radix rdx(m_alloc);
+    if (key.empty()){
+      rdx.TakeTree(*this);
+      return rdx;
+    }
+
+    size_t depth;
+    node_ptr node = FindPrefix(key, depth);
+    if (!node){
+      return rdx;
+    }
+    node_ptr parent = node->GetParent();
+    size_t pos = parent->GetChildren().Position(node->GetEdgeByte());
+    std::vector<Cut_level> levels{{m_root, 0, 0, 0}};
+    if (parent == m_root){
+      levels.front() = {m_root, 0, pos, pos + 1};
+    }
+    else {
+      levels.push_back({parent, depth, pos, pos + 1});
+    }
+    Cut(levels, key, rdx);
+    return rdx;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  radix<T,Compare,Allocator,Options> radix<T,Compare,Allocator,Options>::split(const key_type& key){
+    return split<key_type>(key);
+  }
+
+  // Moves the elements from lower_bound(key) to the end into a new radix and returns it. These
+  // are the children after the path of the key, which are detached from this tree as whole
+  // subtrees. Only their nodes are visited once, to count the moved elements and, with a hash
+  // index, to move them to the index of the new radix. Iterators to the moved elements remain
+  // valid and refer to the new radix. If an exception is thrown, this radix is unchanged.
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  radix<T,Compare,Allocator,Options> radix<T,Compare,Allocator,Options>::split(const K& key){
+    radix rdx(m_alloc);
+    if constexpr (!detail::Is_lexicographic<key_compare>::value){
+      // The children of each node are ordered by the comparator, so the node of the lower bound
+      // moves together with the children after it and after each of its ancestors
+      node_ptr bound = FindBound<false>(key_type(detail::KeyView(key)));
+      std::vector<node_ptr> path;
+      for (node_ptr node = bound; node != m_root; node = node->GetParent()){
+        path.push_back(node);
+      }
+      if (path.empty()){
+        return rdx;
+      }
+
+      std::vector<Cut_level> levels;
+      key_type path_key; // Key of the parent of the bound, which covers the depths of all levels
+      node_ptr node = m_root;
+      for (size_t i = path.size(); i-- > 0;){
+        const auto& children = node->GetChildren();
+        size_t pos = children.Position(path[i]->GetEdgeByte());
+        levels.push_back({node, path_key.size(), (i == 0)? pos : pos + 1, children.size()});
+        if (i > 0){
+          path_key.append(path[i]->GetLabel());
+        }
+        node = path[i];
+      }
+      Cut(levels, path_key, rdx);
+      return rdx;
+    }
+    else {
+      std::string_view view = detail::KeyView(key);
+      if (view.empty()){
+        rdx.TakeTree(*this);
+        return rdx;
+      }
+
+      // Along the path of the key, the children with a greater byte move. The child with the
+      // byte of the key moves as well if its key is not less than the key, and is descended into
+      // if its key is a proper prefix of the key.
+      std::vector<Cut_level> levels;
+      node_ptr node = m_root;
+      size_t depth = 0;
+      while (true){
+        const auto& children = node->GetChildren();
+        size_t pos = children.LowerPosition(view[depth]);
+        node_ptr child = (pos < children.size() && children.ByteAt(pos) == static_cast<unsigned char>(view[depth]))?
+            children.ChildAt(pos) : nullptr;
+        if (child){
+          std::string_view label = child->GetLabel();
+          std::string_view rest = view.substr(depth);
+          size_t common_length = detail::CommonPrefix(label, rest);
+          if (common_length == label.size() && common_length < rest.size()){
+            if (node == m_root || pos + 1 < children.size()){
+              levels.push_back({node, depth, pos + 1, children.size()});
+            }
+            node = child;
+            depth += label.size();
+            continue;
+          }
+          if (common_length < rest.size() &&
+              static_cast<unsigned char>(label[common_length]) < static_cast<unsigned char>(rest[common_length])){
+            ++pos;
+          }
+        }
+        if (node == m_root || pos < children.size()){
+          levels.push_back({node, depth, pos, children.size()});
+        }
+        break;
+      }
+      Cut(levels, view, rdx);
+      return rdx;
+    }
+  }
+
+  // Merges the children of a node of the other radix into the node of this radix with the same
+  // key. Nodes of the other radix that are left without elements below them are deleted.
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::MergeChildren(node_ptr node, node_ptr other, radix& rdx, size_type& kept){
+    auto& children = other->GetChildren();
+    size_t pos = 0;
+    while (pos < children.size()){
+      node_ptr remains = MergeChild(node, children.ChildAt(pos), 0, rdx, kept);
+      if (remains && !remains->IsLeaf() && remains->IsChildless()){
+        children.Erase(pos, rdx.m_alloc);
+        detail::Node<T,Compare,Allocator,Options>::Delete(remains, rdx.m_alloc);
+      }
+      else if (remains){
+        ++pos;
+      }
+    }
+  }
+
+  // Merges a child of a node of the other radix below a node of this radix, whose key is the key
+  // of the child without the part of its label from the skipped bytes on. Returns the node of the
+  // other radix that is left in place of the child, or nullptr if the child has moved.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::MergeChild(
+      node_ptr parent, node_ptr child, size_t skip, radix& rdx, size_type& kept){
+
+    std::string_view label = child->GetLabel().substr(skip);
+    node_ptr entry = parent->GetChildren().Find(label.front());
+
+    // No key of this radix shares the next byte, the whole subtree moves
+    if (!entry){
+      Transplant(parent, child, label, rdx);
+      return nullptr;
+    }
+
+    size_t common_length = detail::CommonPrefix(label, entry->GetLabel());
+    if (common_length == entry->GetLabel().size()){
+      if (common_length == label.size()){
+        return MergeNode(entry, child, rdx, kept);
+      }
+      return MergeChild(entry, child, skip + common_length, rdx, kept);
+    }
+
+    // The label of the entry goes on after the common prefix. The key of the child is either the
+    // common prefix, or diverges from the entry after it.
+    node_ptr inner = SplitEdge(entry, common_length);
+    if (common_length == label.size()){
+      return MergeNode(inner, child, rdx, kept);
+    }
+    Transplant(inner, child, label.substr(common_length), rdx);
+    return nullptr;
+  }
+
+  // Merges a node of the other radix into the node of this radix with the same key. Returns the
+  // node of the other radix that is left in its place, or nullptr if there is none.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::MergeNode(
+      node_ptr node, node_ptr other, radix& rdx, size_type& kept){
+
+    MergeChildren(node, other, rdx, kept);
+    if (!other->IsLeaf()){
+      return other;
+    }
+    if (node->IsLeaf()){
+      // The key is in both radix instances, the element stays where it is
+      ++kept;
+      return other;
+    }
+    return TakeLeaf(node, other, rdx);
+  }
+
+  // Splits the edge to a node of this radix after the given length of its label. The new non-leaf
+  // node takes the place of the node, which becomes its only child.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::SplitEdge(node_ptr node, size_t length){
+    std::string_view label = node->GetLabel();
+    node_ptr inner = detail::Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+    try {
+      inner->SetLabel(label.substr(0, length), m_alloc);
+      node->SetLabel(label.substr(length), m_alloc);
+    }
+    catch (...) {
+      detail::Node<T,Compare,Allocator,Options>::Delete(inner, m_alloc);
+      throw;
+    }
+
+    node_ptr parent = node->GetParent();
+    auto& siblings = parent->GetChildren();
+    siblings.Replace(siblings.Position(inner->GetEdgeByte()), inner);
+    inner->SetParent(parent);
+    // A single child is stored inline
+    inner->GetChildren().Insert(0, node->GetEdgeByte(), node, m_alloc);
+    node->SetParent(inner);
+    return inner;
+  }
+
+  // Moves a node of the other radix together with its subtree below a node of this radix, with
+  // the given label
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::Transplant(node_ptr parent, node_ptr child, std::string_view label, radix& rdx){
+    const key_type word(label);
+    auto& old_siblings = child->GetParent()->GetChildren();
+    const size_t old_pos = old_siblings.Position(child->GetEdgeByte());
+
+    // The child is linked to both parents until its label has been changed
+    auto& siblings = parent->GetChildren();
+    siblings.Insert(parent->ChildPosition(word), word.front(), child, m_alloc);
+    try {
+      child->SetLabel(word, m_alloc);
+    }
+    catch (...) {
+      siblings.Erase(siblings.Position(word.front()), m_alloc);
+      throw;
+    }
+    old_siblings.Erase(old_pos, rdx.m_alloc);
+    child->SetParent(parent);
+
+    if constexpr (!std::is_void_v<hasher>){
+      MoveHashed(child, rdx);
+    }
+    if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+      node_ptr first = child->GetFirstLeaf();
+      node_ptr last = child->GetLastDescendant();
+      first->UnlinkLeaves(last);
+      LinkToNeighbours(first, last);
+    }
+  }
+
+  // Moves a leaf of the other radix into the place of the non-leaf node of this radix with the
+  // same key. The leaf takes over the children of the node, which is deleted, and leaves its
+  // own children to a new non-leaf node in the other radix. Returns that node, or nullptr if
+  // the leaf has no children.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::TakeLeaf(node_ptr inner, node_ptr leaf, radix& rdx){
+    node_ptr substitute = nullptr;
+    if (!leaf->IsChildless()){
+      substitute = detail::Node<T,Compare,Allocator,Options>::NewInner(rdx.m_alloc);
+      try {
+        substitute->SetLabel(leaf->GetLabel(), rdx.m_alloc);
+      }
+      catch (...) {
+        detail::Node<T,Compare,Allocator,Options>::Delete(substitute, rdx.m_alloc);
+        throw;
+      }
+      substitute->GetChildren().swap(leaf->GetChildren());
+      for (node_ptr child : substitute->GetChildren()){
+        child->SetParent(substitute);
+      }
+    }
+
+    // Out of the other radix
+    auto& old_siblings = leaf->GetParent()->GetChildren();
+    const size_t old_pos = old_siblings.Position(leaf->GetEdgeByte());
+    if (substitute){
+      old_siblings.Replace(old_pos, substitute);
+      substitute->SetParent(leaf->GetParent());
+    }
+    else {
+      old_siblings.Erase(old_pos, rdx.m_alloc);
+    }
+    if constexpr (!std::is_void_v<hasher>){
+      rdx.m_hash_index.Erase(leaf);
+    }
+    if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+      leaf->UnlinkLeaf();
+    }
+
+    // Into this radix, a leaf label refers to the key and is set without allocating
+    leaf->SetLabel(inner->GetLabel(), m_alloc);
+    leaf->GetChildren().swap(inner->GetChildren());
+    for (node_ptr child : leaf->GetChildren()){
+      child->SetParent(leaf);
+    }
+    auto& siblings = inner->GetParent()->GetChildren();
+    siblings.Replace(siblings.Position(inner->GetEdgeByte()), leaf);
+    leaf->SetParent(inner->GetParent());
+    detail::Node<T,Compare,Allocator,Options>::Delete(inner, m_alloc);
+
+    if constexpr (!std::is_void_v<hasher>){
+      m_hash_index.Insert(leaf);
+    }
+    if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+      LinkToNeighbours(leaf, leaf);
+    }
+    return substitute;
+  }
+
+  // Moves the leaves of a subtree from the hash index of the other radix to the one of this
+  // radix, which has room for them
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::MoveHashed(node_ptr node, radix& rdx) noexcept {
+    ForEachLeaf(node, [&](node_ptr leaf){
+      rdx.m_hash_index.Erase(leaf);
+      m_hash_index.Insert(leaf);
+    });
+  }
+
+  // Moves the children of the nodes on the path of a cut along the key, at the positions given for
+  // each node, into the other radix, which is empty and uses an equal allocator. The first level
+  // is the root. In the other radix, the moved children are gathered below new non-leaf nodes with
+  // the keys of their old parents, and a node that would gather only a single subtree is left out.
+  // That subtree then hangs higher up and needs a longer label, so a non-leaf node at its top is
+  // replaced by a new one. All nodes are allocated before the first node moves, so an exception
+  // leaves this radix unchanged.
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::Cut(const std::vector<Cut_level>& levels, std::string_view key, radix& rdx){
+    struct Move{
+      node_ptr node;
+      node_ptr parent;
+      node_ptr substitute; // New node that takes the place of a moved non-leaf node
+      bool relabel;        // The label of the node starts after the key of its new parent
+      size_t depth;        // Length of the key of the new parent
+    };
+
+    size_t child_count = 0;
+    for (const Cut_level& level : levels){
+      child_count += level.last - level.first;
+    }
+    if (child_count == 0){
+      return;
+    }
+    std::vector<Move> moves;
+    moves.reserve(child_count + 1);
+    std::vector<node_ptr> created;
+    created.reserve(levels.size() + 1);
+    rdx.EnsureRoot();
+
+    size_type moved = 0;
+    for (const Cut_level& level : levels){
+      for (size_t pos = level.first; pos < level.last; ++pos){
+        moved += CountLeaves(level.node->GetChildren().ChildAt(pos));
+      }
+    }
+    try {
+      if constexpr (!std::is_void_v<hasher>){
+        rdx.m_hash_index.Reserve(moved, m_alloc);
+      }
+
+      // Bottom-up, the pending node holds everything that moves below the levels visited so far.
+      // It is either a new node, or a moved child of the node of a deeper level.
+      node_ptr pending = nullptr;
+      size_t pending_depth = 0;
+      bool pending_created = false;
+      for (size_t i = levels.size(); i-- > 0;){
+        const Cut_level& level = levels[i];
+        const auto& children = level.node->GetChildren();
+        if (level.first == level.last && !pending){
+          continue;
+        }
+        if (i > 0 && level.last - level.first + (pending? 1 : 0) == 1){
+          if (!pending){
+            pending = children.ChildAt(level.first);
+            pending_depth = level.depth;
+          }
+          continue;
+        }
+
+        node_ptr gather = rdx.m_root;
+        if (i > 0){
+          gather = detail::Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+          created.push_back(gather);
+        }
+        auto& gathered = gather->GetChildren();
+        if (pending){
+          std::string_view prefix = key.substr(level.depth, pending_depth - level.depth);
+          if (pending_created){
+            pending->SetLabel(prefix, m_alloc);
+            gathered.Insert(0, prefix.front(), pending, m_alloc);
+            pending->SetParent(gather);
+          }
+          else if (pending->IsLeaf()){
+            gathered.Insert(0, prefix.front(), pending, m_alloc);
+            moves.push_back({pending, gather, nullptr, true, level.depth});
+          }
+          else {
+            node_ptr substitute = detail::Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+            created.push_back(substitute);
+            substitute->SetLabel(key_type(prefix) + key_type(pending->GetLabel()), m_alloc);
+            gathered.Insert(0, prefix.front(), substitute, m_alloc);
+            substitute->SetParent(gather);
+            moves.push_back({pending, gather, substitute, false, level.depth});
+          }
+        }
+        for (size_t pos = level.first; pos < level.last; ++pos){
+          node_ptr child = children.ChildAt(pos);
+          gathered.Insert(gathered.size(), child->GetEdgeByte(), child, m_alloc);
+          moves.push_back({child, gather, nullptr, false, level.depth});
+        }
+        pending = gather;
+        pending_depth = level.depth;
+        pending_created = true;
+      }
+    }
+    catch (...) {
+      // The new nodes only refer to the moved children, which are still in this radix
+      for (node_ptr node : created){
+        node->GetChildren().Release(m_alloc);
+        detail::Node<T,Compare,Allocator,Options>::Delete(node, m_alloc);
+      }
+      rdx.m_root->GetChildren().Release(m_alloc);
+      throw;
+    }
+
+    // Nothing below allocates
+    unsigned char bytes[257];
+    size_t byte_count = 0;
+    if constexpr (root_index_bytes){
+      if (!key.empty()){
+        bytes[byte_count++] = key.front();
+      }
+      for (size_t pos = levels.front().first; pos < levels.front().last; ++pos){
+        bytes[byte_count++] = m_root->GetChildren().ByteAt(pos);
+      }
+    }
+    for (const Cut_level& level : levels){
+      auto& children = level.node->GetChildren();
+      for (size_t pos = level.last; pos-- > level.first;){
+        children.Erase(pos, m_alloc);
+      }
+    }
+    for (const Move& move : moves){
+      if (move.substitute){
+        auto& children = move.substitute->GetChildren();
+        children.swap(move.node->GetChildren());
+        for (node_ptr child : children){
+          child->SetParent(move.substitute);
+        }
+        detail::Node<T,Compare,Allocator,Options>::Delete(move.node, m_alloc);
+        continue;
+      }
+      if (move.relabel){
+        move.node->SetLabel(std::string_view(move.node->GetKey()).substr(move.depth), m_alloc);
+      }
+      move.node->SetParent(move.parent);
+    }
+
+    // Only the deepest node on the path can have lost all its children, and with it its ancestors
+    Prune(levels.back().node);
+
+    if constexpr (!std::is_void_v<hasher>){
+      for (node_ptr child : rdx.m_root->GetChildren()){
+        rdx.MoveHashed(child, *this);
+      }
+    }
+    m_size -= moved;
+    rdx.m_size = moved;
+    if constexpr (detail::Node<T,Compare,Allocator,Options>::leaf_links){
+      // The moved leaves are consecutive
+      rdx.m_root->GetChildren().Front()->GetFirstLeaf()->UnlinkLeaves(rdx.m_root->GetLastDescendant());
+    }
+    if constexpr (root_index_bytes){
+      for (size_t i = 0; i < byte_count; ++i){
+        UpdateIndex(bytes[i]);
+      }
+      for (node_ptr child : rdx.m_root->GetChildren()){
+        rdx.UpdateIndex(child->GetEdgeByte());
+      }
+    }
+    if constexpr (lookup_cache_entries != 0){
+      m_cache.Clear();
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::size_type radix<T,Compare,Allocator,Options>::CountLeaves(node_ptr node) noexcept {
+    size_type count = 0;
+    ForEachLeaf(node, [&](node_ptr){ ++count; });
+    return count;
+  }
+
+  // Calls the function for every leaf of a subtree in order. The walk goes down to the first child
+  // and on to the next sibling, climbing no higher than the top of the subtree, so that a deep
+  // subtree, such as a long chain of single bytes, does not exhaust the stack.
+  template <class T, class Compare, class Allocator, class Options> template <class Function>
+  void radix<T,Compare,Allocator,Options>::ForEachLeaf(node_ptr top, Function function) noexcept {
+    node_ptr node = top;
+    while (true){
+      if (node->IsLeaf()){
+        function(node);
+      }
+      if (!node->IsChildless()){
+        node = node->GetFirstChild();
+        continue;
+      }
+      for (; node != top; node = node->GetParent()){
+        const auto& siblings = node->GetParent()->GetChildren();
+        size_t pos = siblings.Position(node->GetEdgeByte()) + 1;
+        if (pos < siblings.size()){
+          node = siblings.ChildAt(pos);
+          break;
+        }
+      }
+      if (node == top){
+        return;
+      }
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::clear(){
+    DeleteTree();
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  T& radix<T,Compare,Allocator,Options>::at(const key_type& key){
+    return at<key_type>(key);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  const T& radix<T,Compare,Allocator,Options>::at(const key_type& key) const {
+    return at<key_type>(key);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  T& radix<T,Compare,Allocator,Options>::at(const K& key){
+    return const_cast<T&>(std::as_const(*this).at(key));
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  const T& radix<T,Compare,Allocator,Options>::at(const K& key) const {
+    const_node_ptr node = Lookup(detail::KeyView(key));
+    if (!node){
+      throw std::out_of_range("radix::at:  key not found");
+    }
+    return node->GetValuePair().second;
+  }
+
+  // All exact-match operations go through this function. Returns the leaf node of the key, or
+  // nullptr if there is no such element. With a lookup cache, the leaves that have been found
+  // are remembered and answer the next lookups of their keys.
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::Lookup(std::string_view key) const {
+    if constexpr (lookup_cache_entries != 0){
+      const size_t hash = lookup_cache::Hash(key);
+      node_ptr node = m_cache.Find(key, hash);
+      if (!node){
+        node = FindLeaf(key);
+        if (node){
+          m_cache.Store(hash, node);
+        }
+      }
+      return node;
+    }
+    else {
+      return FindLeaf(key);
+    }
+  }
+
+  // Exact match with the hash index if there is one, otherwise with a single descent
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::FindLeaf(std::string_view key) const {
+    if constexpr (!std::is_void_v<hasher>){
+      return m_hash_index.Find(key);
+    }
+    else {
+      node_ptr node = IndexedStart(key)->Retrieve(key);
+      return (node && node->IsLeaf())? node : nullptr;
+    }
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::find(const key_type& key){
+    node_ptr node = Lookup(key);
+    return node? iterator(node) : end();
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::find(const key_type& key) const {
+    node_ptr node = Lookup(key);
+    return node? const_iterator(node) : cend();
+  }
+
+  // Keys that are sequences of char are matched exactly like key_type, other key types are
+  // compared with the transparent comparator
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::find(const K& key){
+    if constexpr (detail::Contiguous_key<K>){
+      node_ptr node = Lookup(detail::KeyView(key));
+      return node? iterator(node) : end();
+    }
+    else {
+      iterator it = lower_bound(key);
+
+      const Compare comp;
+      return (it != end() && !comp(value_traits::GetKey(*it), key) && !comp(key, value_traits::GetKey(*it)))? it : end();
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::find(const K& key) const {
+    if constexpr (detail::Contiguous_key<K>){
+      node_ptr node = Lookup(detail::KeyView(key));
+      return node? const_iterator(node) : cend();
+    }
+    else {
+      const_iterator it = lower_bound(key);
+
+      Compare comp;
+      return (it != cend() && !comp(value_traits::GetKey(*it), key) && !comp(key, value_traits::GetKey(*it)))? it : cend();
+    }
+  }
+
+  // Finger search: the lookup climbs from the hint to the lowest ancestor that the hint shares
+  // with the key and descends from there, which is short if the key is close to the hint. The
+  // hint must be an iterator of this radix, end() searches from the root. With a hash index,
+  // the index is faster and the hint is ignored.
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::find(const_iterator hint, const K& key){
+    const_iterator it = std::as_const(*this).find(hint, key);
+    return (it == cend())? end() : iterator(it.m_node);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::find(const_iterator hint, const K& key) const {
+    if constexpr (!std::is_void_v<hasher>){
+      return find(key);
+    }
+    else {
+      std::string_view view = detail::KeyView(key);
+      node_ptr node = Finger(hint.GetNode(), view)->Retrieve(view);
+      return (node && node->IsLeaf())? const_iterator(node) : cend();
+    }
+  }
+
+  // Batched exact match: out[i] is the iterator of keys[i], or end(). The output must hold at
+  // least as many iterators as there are keys.
+  template <class T, class Compare, class Allocator, class Options> template <detail::Key_range R>
+  void radix<T,Compare,Allocator,Options>::find_many(const R& keys, std::span<iterator> out){
+    assert(out.size() >= std::ranges::size(keys));
+    LookupMany(keys, [&](size_t i, node_ptr node){ out[i] = node? iterator(node) : end(); });
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Key_range R>
+  void radix<T,Compare,Allocator,Options>::find_many(const R& keys, std::span<const_iterator> out) const {
+    assert(out.size() >= std::ranges::size(keys));
+    LookupMany(keys, [&](size_t i, node_ptr node){ out[i] = node? const_iterator(node) : cend(); });
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Key_range R>
+  void radix<T,Compare,Allocator,Options>::contains_many(const R& keys, std::span<bool> out) const {
+    assert(out.size() >= std::ranges::size(keys));
+    LookupMany(keys, [&](size_t i, node_ptr node){ out[i] = node != nullptr; });
+  }
+
+  // Looks up all keys and calls visit(i, leaf node of keys[i] or nullptr), in no particular
+  // order of i. A single descent stalls on a cache miss at every level, so up to `width`
+  // descents are advanced in turns: each turn moves one descent a level down and prefetches
+  // the next node, which is then loaded while the other descents take their turns.
+  // The hash index and the lookup cache answer from a single probe, they are used key by key.
+  // So are ranges that yield temporary keys, which do not outlive a turn.
+  template <class T, class Compare, class Allocator, class Options> template <class R, class Visit>
+  void radix<T,Compare,Allocator,Options>::LookupMany(const R& keys, Visit visit) const {
+    const size_t count = std::ranges::size(keys);
+    auto first = std::ranges::begin(keys);
+
+    if constexpr (!std::is_void_v<hasher> || lookup_cache_entries != 0 ||
+                  !std::is_lvalue_reference_v<std::ranges::range_reference_t<const R>>){
+      for (size_t i = 0; i < count; ++i){
+        visit(i, Lookup(detail::KeyView(first[i])));
+      }
+    }
+    else {
+      struct Descent{
+        node_ptr node;        // Node whose key is a prefix of the key, or that is prefetched
+        std::string_view key; // Rest of the key below node
+        size_t index;
+      };
+
+      // Moves from a node that matches the key to the child for the next byte, and prefetches
+      // it. Returns false when the descent has ended, with the result in node.
+      auto advance = [](Descent& d){
+        if (d.key.empty()){
+          if (!d.node->IsLeaf()){
+            d.node = nullptr;
+          }
+          return false;
+        }
+        d.node = d.node->GetChildren().Find(d.key.front());
+        if (!d.node){
+          return false;
+        }
+        detail::Prefetch(d.node);
+        return true;
+      };
+
+      // Matches the edge label of the prefetched node and advances
+      auto step = [&](Descent& d){
+        std::string_view label = d.node->GetLabel();
+        if (!d.key.starts_with(label)){
+          d.node = nullptr;
+          return false;
+        }
+        d.key.remove_prefix(label.size());
+        return advance(d);
+      };
+
+      // Starts the descent of the next key, returns false if there is none left
+      size_t next = 0;
+      auto launch = [&](Descent& d){
+        while (next < count){
+          d.index = next++;
+          d.key = detail::KeyView(first[d.index]);
+          d.node = IndexedStart(d.key);
+          if (advance(d)){
+            return true;
+          }
+          visit(d.index, d.node);
+        }
+        return false;
+      };
+
+      constexpr size_t width = 8;
+      Descent descents[width];
+      size_t active = 0;
+      while (active < width && launch(descents[active])){
+        ++active;
+      }
+
+      while (active){
+        for (size_t slot = 0; slot < active;){
+          Descent& d = descents[slot];
+          if (!step(d)){
+            visit(d.index, d.node);
+            if (!launch(d)){
+              // No keys left, the last descent takes the slot and its turn
+              d = descents[--active];
+              continue;
+            }
+          }
+          ++slot;
+        }
+      }
+    }
+  }
+
+  /////////////////
+  // LOWER BOUND //
+  /////////////////
+
+  // Finds the first node whose key is not smaller than the key, or with Upper, greater than the
+  // key. With a lexicographic comparator, keys that are sequences of char are located byte by
+  // byte. Other keys are compared with the comparator to the children of each node in turn.
+  template <class T, class Compare, class Allocator, class Options> template <bool Upper, class K>
+  typename radix<T,Compare,Allocator,Options>::node_ptr radix<T,Compare,Allocator,Options>::FindBound(const K& key) const {
+    if constexpr (detail::Is_lexicographic<Compare>::value && detail::Contiguous_key<K>){
+      std::string_view view = detail::KeyView(key);
+      node_ptr start = IndexedStart(view);
+      return start->template FindBoundNonLeaf<Upper>(view, SubtreeEnd(start));
+    }
+    else if constexpr (Upper){
+      return m_root->FindConditionNonLeaf(radix::conditionUpper<K>, key);
+    }
+    else {
+      return m_root->FindConditionNonLeaf(radix::conditionLower<K>, key);
+    }
+  }
+
+  // Condition for finding first item that is not smaller than key
+  // Used in lower_bound
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  bool radix<T,Compare,Allocator,Options>::conditionLower(const key_type& tree_key, const K& key){
+    const Compare comp;
+    return !comp(tree_key,key);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::lower_bound(const key_type& key){
+    return iterator(FindBound<false>(key)->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::lower_bound(const key_type& key) const {
+    return const_iterator(FindBound<false>(key)->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::lower_bound(const K& key){
+    return iterator(FindBound<false>(key)->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::lower_bound(const K& key) const {
+    return const_iterator(FindBound<false>(key)->GetFirstLeaf());
+  }
+
+  // Finger search, see find(const_iterator, const K&)
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::lower_bound(const_iterator hint, const K& key){
+    return iterator(FingerBound(hint.GetNode(), detail::KeyView(key))->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <detail::Contiguous_key K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::lower_bound(const_iterator hint, const K& key) const {
+    return const_iterator(FingerBound(hint.GetNode(), detail::KeyView(key))->GetFirstLeaf());
+  }
+
+  /////////////////
+  // UPPER BOUND //
+  /////////////////
+  
+  // Condition for finding first item that is greater than key
+  // Used in upper_bound
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  bool radix<T,Compare,Allocator,Options>::conditionUpper(const key_type& tree_key, const K& key){
+    Compare comp;
+    return comp(key, tree_key);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::upper_bound(const key_type& key){
+    return iterator(FindBound<true>(key)->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::upper_bound(const key_type& key) const {
+    return const_iterator(FindBound<true>(key)->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::iterator radix<T,Compare,Allocator,Options>::upper_bound(const K& key){
+    return iterator(FindBound<true>(key)->GetFirstLeaf());
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator radix<T,Compare,Allocator,Options>::upper_bound(const K& key) const {
+    return const_iterator(FindBound<true>(key)->GetFirstLeaf());
+  }
+
+  /////////////////
+  // EQUAL RANGE //
+  /////////////////
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::iterator_pair radix<T,Compare,Allocator,Options>::equal_range(const key_type& key)
+  {
+    iterator lb = lower_bound(key);
+    iterator ub;
+    for (ub = lb; ub != cend() && !radix::conditionUpper(value_traits::GetKey(*ub),key); ++ub){}
+
+    return std::make_pair(lb, ub);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_iterator_pair radix<T,Compare,Allocator,Options>::equal_range(const key_type& key) const
+  {
+    const_iterator lb = lower_bound(key);
+    const_iterator ub;
+    for (ub = lb; ub != cend() && !radix::conditionUpper(value_traits::GetKey(*ub),key); ++ub){}
+
+    return std::make_pair(lb, ub);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::iterator_pair radix<T,Compare,Allocator,Options>::equal_range(const K& key)
+  {
+    iterator lb = lower_bound(key);
+    iterator ub;
+    for (ub = lb; ub != cend() && !radix::conditionUpper(value_traits::GetKey(*ub),key); ++ub){}
+
+    return std::make_pair(lb, ub);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename radix<T,Compare,Allocator,Options>::const_iterator_pair radix<T,Compare,Allocator,Options>::equal_range(const K& key) const
+  {
+    const_iterator lb = lower_bound(key);
+    const_iterator ub;
+    for (ub = lb; ub != cend() && !radix::conditionUpper(value_traits::GetKey(*ub),key); ++ub){}
+
+    return std::make_pair(lb, ub);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  T& radix<T,Compare,Allocator,Options>::operator[](const key_type& key){
+    // Existing elements are looked up without creating a node
+    if (node_ptr node = Lookup(key)){
+      return node->GetValuePair().second;
+    }
+    return emplace(key, T()).first->second;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename xsm::radix<T,Compare,Allocator,Options>::size_type xsm::radix<T,Compare,Allocator,Options>::count(const key_type& key) const {
+    return contains(key)? 1 : 0;
+  }
+  
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename xsm::radix<T,Compare,Allocator,Options>::size_type xsm::radix<T,Compare,Allocator,Options>::count(const K& key) const {
+    if constexpr (detail::Contiguous_key<K>){
+      return Lookup(detail::KeyView(key))? 1 : 0;
+    }
+    else {
+      size_type i = 0;
+      for (auto it = lower_bound(key); it != cend() && !radix::conditionUpper(value_traits::GetKey(*it),key); ++it){
+        ++i;
+      }
+      return i;
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  bool radix<T,Compare,Allocator,Options>::contains(const key_type& key) const {
+    return Lookup(key);
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  bool radix<T,Compare,Allocator,Options>::contains(const K& key) const {
+    return (find(key) != cend());
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  detail::Iterator_impl<T,Compare,Allocator,Options> radix<T,Compare,Allocator,Options>::begin() noexcept {
+    if (m_root->IsChildless()){
+      return end();
+    }
+    // need to increment because the root node is not a leaf node
+    return ++iterator(m_root);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  detail::Iterator_impl<T,Compare,Allocator,Options,const T> radix<T,Compare,Allocator,Options>::begin() const noexcept {
+    return cbegin();
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  detail::Iterator_impl<T,Compare,Allocator,Options> radix<T,Compare,Allocator,Options>::end() noexcept {
+    return iterator::End(m_root);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  detail::Iterator_impl<T,Compare,Allocator,Options,const T> radix<T,Compare,Allocator,Options>::end() const noexcept {
+    return cend();
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::reverse_iterator radix<T,Compare,Allocator,Options>::rbegin() noexcept {
+    return reverse_iterator(end());
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_reverse_iterator radix<T,Compare,Allocator,Options>::rbegin() const noexcept {
+    return crbegin();
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::reverse_iterator radix<T,Compare,Allocator,Options>::rend() noexcept {
+    return reverse_iterator(begin());
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_reverse_iterator radix<T,Compare,Allocator,Options>::rend() const noexcept {
+    return crend();
+  }
 
-            m_size++;
-            return std::make_pair(iterator(nh.m_node_ptr), true);
-          }
-          else {
-            // Insertion unsuccessful, return iterator to existing element
-            return std::make_pair(iterator(entry.second), false);
-          }
-        }
+  template <class T, class Compare, class Allocator, class Options>
+  detail::Iterator_impl<T,Compare,Allocator,Options,const T> radix<T,Compare,Allocator,Options>::cbegin() const noexcept {
+    if (m_root->IsChildless()){
+      return cend();
+    }
+    return ++const_iterator(m_root);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  detail::Iterator_impl<T,Compare,Allocator,Options,const T> radix<T,Compare,Allocator,Options>::cend() const noexcept {
+    return const_iterator::End(m_root);
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_reverse_iterator radix<T,Compare,Allocator,Options>::crbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  typename radix<T,Compare,Allocator,Options>::const_reverse_iterator radix<T,Compare,Allocator,Options>::crend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+  
+  template <class T, class Compare, class Allocator, class Options>
+  void radix<T,Compare,Allocator,Options>::print() const {
+    std::cout << "ROOT";
+    m_root->print();
+    std::cout << "\n" << std::flush;
+  }
+}
 
-        // 3. One key is prefix of the other -> The prefix key becomes the parent of the other entry
-        else if (key_end == last_match.first || entrykey_end == last_match.second){
-          // New keyword is prefix of the existing nodekey
-          if (key_end == last_match.first){
-            // Add a new node with the prefix to the current node
-            parent.m_node->AddChild(key_type(key_start, key_end), nh.m_node_ptr);
-            // Old child node becomes child of the new node
-            nh.m_node_ptr->AddChild(key_type(last_match.second, entrykey_end), entry.second);
-            // Remove old node from current node
-            parent.m_node->GetChildren().erase(entry.first);
+namespace xsm::detail{ 
+  ////////////////
+  // LOOKUP KEY //
+  ////////////////
+  template <Contiguous_key K>
+  std::string_view KeyView(const K& key) noexcept {
+    if constexpr (std::is_convertible_v<const K&, std::string_view>){
+      return key;
+    }
+    else {
+      return std::string_view(std::ranges::data(key), std::ranges::size(key));
+    }
+  }
 
-            m_size++;
-            return std::make_pair(iterator(nh.m_node_ptr),true);
-          }
-          else {
-            // Insert new keyword as child of its prefix
-            key_start = last_match.first;
-            parent = iterator(entry.second);
-            next_child = true;
-            break;
-          }
+  inline size_t CommonPrefix(std::string_view lhs, std::string_view rhs) noexcept {
+    const char* a = lhs.data();
+    const char* b = rhs.data();
+    const size_t n = std::min(lhs.size(), rhs.size());
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= n; i += 32){
+      __m256i cmp = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+      unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(cmp));
+      if (mask){
+        return i + std::countr_zero(mask);
+      }
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= n; i += 16){
+      __m128i cmp = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+      unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(cmp)) & 0xffffu;
+      if (mask){
+        return i + std::countr_zero(mask);
+      }
+    }
+#endif
+    for (; i + 8 <= n; i += 8){
+      uint64_t x, y;
+      std::memcpy(&x, a + i, 8);
+      std::memcpy(&y, b + i, 8);
+      if (x != y){
+        if constexpr (std::endian::native == std::endian::little){
+          return i + std::countr_zero(x ^ y) / 8;
         }
-
-        // 4. Words partially match but diverge
-        // -> A new node needs to be created whose key is the common prefix of the words.
-        // This node has two children, one representing the new key, the other representing the
-        // entry key
         else {
-          key_type common_prefix(key_start, last_match.first);
-
-          // New parent
-          node_ptr parent_ptr = parent.m_node->AddChild(key_type(key_start, last_match.first));
-          // Old entry
-          parent_ptr->AddChild(key_type(last_match.second,entrykey_end), entry.second);
-          entry.second->SetParent(parent_ptr);
-          parent.m_node->GetChildren().erase(entry.first); 
-          // New entry
-          parent_ptr->AddChild(key_type(last_match.first,key_end), nh.m_node_ptr);
-
-          m_size++;
-          return std::make_pair(iterator(nh.m_node_ptr),true);
+          return i + std::countl_zero(x ^ y) / 8;
         }
       }
-    } while (next_child);
-    
-    // 5. No common prefix has been found in any children -> keyword becomes a new entry
-    parent.m_node->AddChild(key_type(key_start, key_end), nh.m_node_ptr);
-    m_size++;
-    return std::make_pair(iterator(nh.m_node_ptr), true);
-  }
-  
-  template <class T, class Compare> template <class... Args>
-  std::pair<detail::Iterator_impl<T,Compare>,bool> radix<T,Compare>::emplace(Args&&... args){
-    
-    node_ptr node = new detail::Node<T,Compare>(nullptr, true, std::forward<Args>(args)...);
-    return NodeInTree(node_type(node), iterator(m_root), node->GetKey().begin());
+    }
+    while (i < n && a[i] == b[i]){
+      ++i;
+    }
+    return i;
   }
 
-  template <class T, class Compare> template <class... Args>
-  typename radix<T,Compare>::iterator radix<T,Compare>::emplace_hint(const_iterator pos, Args&&... args){
-    
-    node_ptr node = new detail::Node<T,Compare>(nullptr, true, std::forward<Args>(args)...);
+  inline void Prefetch([[maybe_unused]] const void* ptr) noexcept {
+#if defined(__SSE2__)
+    _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(ptr);
+#endif
+  }
 
-    const_iterator parent = --pos;
-    key_type::const_iterator key_start = ProcessHint(parent, node);
+  ////////////////////
+  // PARALLEL LOOPS //
+  ////////////////////
+  template <class F>
+  void ParallelFor(size_t n, unsigned threads, F f){
+    std::atomic<size_t> next(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&](){
+      for (size_t i = next++; i < n && !failed; i = next++){
+        try {
+          f(i);
+        }
+        catch (...) {
+          std::lock_guard<std::mutex> lock(error_mutex);
+          if (!error){
+            error = std::current_exception();
+          }
+          failed = true;
+        }
+      }
+    };
+
+    // If threads cannot be started, the work is shared among fewer
+    std::vector<std::thread> workers;
+    try {
+      const size_t extra = std::min<size_t>(threads, n) - std::min<size_t>(1, n);
+      workers.reserve(extra);
+      for (size_t t = 0; t < extra; ++t){
+        workers.emplace_back(work);
+      }
+    }
+    catch (...) {}
 
-    return NodeInTree(node_type(node), parent, key_start).first;
+    work();
+    for (std::thread& worker : workers){
+      worker.join();
+    }
+    if (error){
+      std::rethrow_exception(error);
+    }
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::erase(iterator it){
-    return erase(const_iterator(it));
+  ////////////////
+  // ALLOCATION //
+  ////////////////
+  template <class U, class Alloc>
+  U* Allocate(const Alloc& alloc, size_t n){
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<U> rebound_alloc;
+    rebound_alloc rebound(alloc);
+    return std::to_address(std::allocator_traits<rebound_alloc>::allocate(rebound, n));
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::erase(const_iterator it){
-    // Passing and iterator that equals end() will result in an error (Seg fault)
-    // This is the same behaviour as in std::map, so there is no need to check for
-    // this case.
-    auto ret_it = it;
-    ++ret_it;
-    extract(it);
-    return iterator(ret_it.m_node);
+  template <class U, class Alloc>
+  void Deallocate(U* ptr, const Alloc& alloc, size_t n) noexcept {
+    typedef typename std::allocator_traits<Alloc>::template rebind_alloc<U> rebound_alloc;
+    rebound_alloc rebound(alloc);
+    std::allocator_traits<rebound_alloc>::deallocate(rebound, ptr, n);
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::erase(const_iterator first, const_iterator last){
-    while (first != last){
-      first = erase(first);
+  ////////////////
+  // EDGE LABEL //
+  ////////////////
+  inline Edge_label::Edge_label() noexcept : m_bytes(), m_size(0) {}
+
+  // Stores a copy of the label
+  template <class Alloc>
+  void Edge_label::Assign(std::string_view label, const Alloc& alloc){
+    // The label may refer to the current buffer, which is only released after copying
+    if (label.size() <= inline_capacity){
+      char bytes[inline_capacity];
+      std::memcpy(bytes, label.data(), label.size());
+      Release(alloc);
+      std::memcpy(m_bytes, bytes, label.size());
+    }
+    else {
+      char* data = Allocate<char>(alloc, label.size());
+      std::memcpy(data, label.data(), label.size());
+      Release(alloc);
+      SetHeapData(data);
     }
-    return iterator(last.m_node);
+    m_size = static_cast<uint32_t>(label.size());
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::size_type radix<T,Compare>::erase(const key_type& key){
-    if (contains(key)){
-      erase(find(key));
-      return 1;
+  // Refers to the label without copying it, unless it fits inline
+  template <class Alloc>
+  void Edge_label::Borrow(std::string_view label, const Alloc& alloc){
+    Release(alloc);
+    if (label.size() <= inline_capacity){
+      std::memcpy(m_bytes, label.data(), label.size());
+      m_size = static_cast<uint32_t>(label.size());
+    }
+    else {
+      SetHeapData(label.data());
+      m_size = static_cast<uint32_t>(label.size()) | borrowed_flag;
     }
-    return 0;
   }
 
-  template <class T, class Compare>
-  void radix<T,Compare>::swap(radix<T,Compare>& rdx){
-    // swap m_root
-    {
-      node_ptr temp = m_root;
-      m_root = rdx.m_root;
-      rdx.m_root = temp;
-    }
-    // swap m_size
-    {
-      size_t temp = m_size;
-      m_size = rdx.m_size;
-      rdx.m_size = temp;
+  template <class Alloc>
+  void Edge_label::Release(const Alloc& alloc) noexcept {
+    if (!IsInline() && !(m_size & borrowed_flag)){
+      Deallocate(const_cast<char*>(HeapData()), alloc, size());
     }
+    m_size = 0;
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::node_type radix<T,Compare>::extract(const_iterator it){
+  inline std::string_view Edge_label::View() const noexcept {
+    return std::string_view(IsInline()? m_bytes : HeapData(), size());
+  }
 
-    node_ptr extracted = it.m_node->Extract();
+  inline size_t Edge_label::size() const noexcept {
+    return m_size & ~borrowed_flag;
+  }
 
-    // Decrementing the counter causes an issue when the iterator doesn't point to an element in this radix
-    // but this is the same behaviour as in std::map
-    --m_size;
+  inline bool Edge_label::IsInline() const noexcept {
+    return size() <= inline_capacity;
+  }
+
+  inline const char* Edge_label::HeapData() const noexcept {
+    const char* data;
+    std::memcpy(&data, m_bytes, sizeof(data));
+    return data;
+  }
+
+  inline void Edge_label::SetHeapData(const char* data) noexcept {
+    std::memcpy(m_bytes, &data, sizeof(data));
+  }
+
+  //////////
+  // LINK //
+  //////////
+  template <class NodePtr, bool Compact>
+  NodePtr Link<NodePtr,Compact>::Load(const type& link) noexcept {
+    return reinterpret_cast<NodePtr>(link & ~type(1));
+  }
+
+  template <class NodePtr, bool Compact>
+  void Link<NodePtr,Compact>::Store(type& link, NodePtr ptr, bool tag) noexcept {
+    assert(!(reinterpret_cast<type>(ptr) & 1));
+    link = reinterpret_cast<type>(ptr) | type(tag);
+  }
+
+  template <class NodePtr, bool Compact>
+  bool Link<NodePtr,Compact>::Tag(const type& link) noexcept {
+    return link & 1;
+  }
+
+  template <class NodePtr, bool Compact>
+  void Link<NodePtr,Compact>::Copy(const type* first, const type* last, type* dest) noexcept {
+    std::copy(first, last, dest);
+  }
 
-    return node_type(extracted);
+  template <class NodePtr, bool Compact>
+  void Link<NodePtr,Compact>::CopyBackward(const type* first, const type* last, type* dest_last) noexcept {
+    std::copy_backward(first, last, dest_last);
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::node_type radix<T,Compare>::extract(const key_type& key){
-    if (contains(key)){
-      return extract(find(key));
+  // The offset is stored above the tag bit
+  template <class NodePtr>
+  NodePtr Link<NodePtr,true>::Load(const type& link) noexcept {
+    const intptr_t units = link >> 1;
+    if (!units){
+      return nullptr;
     }
-    else {
-      return node_type();
+    const uintptr_t base = reinterpret_cast<uintptr_t>(&link) & ~uintptr_t(link_granularity - 1);
+    return reinterpret_cast<NodePtr>(base + static_cast<uintptr_t>(units * intptr_t(link_granularity)));
+  }
+
+  template <class NodePtr>
+  void Link<NodePtr,true>::Store(type& link, NodePtr ptr, bool tag) noexcept {
+    if (!ptr){
+      link = tag;
+      return;
     }
+    const uintptr_t base = reinterpret_cast<uintptr_t>(&link) & ~uintptr_t(link_granularity - 1);
+    const intptr_t distance = static_cast<intptr_t>(reinterpret_cast<uintptr_t>(ptr) - base);
+    const intptr_t units = distance / intptr_t(link_granularity);
+    assert(distance % intptr_t(link_granularity) == 0);
+    assert(units >= (INT32_MIN >> 1) && units <= (INT32_MAX >> 1));
+    link = static_cast<int32_t>(units * 2) | static_cast<int32_t>(tag);
   }
 
-  template <class T, class Compare>
-  void radix<T,Compare>::clear(){
-    delete m_root;
-    m_root = new detail::Node<T,Compare>();
-    m_size = 0;
+  template <class NodePtr>
+  bool Link<NodePtr,true>::Tag(const type& link) noexcept {
+    return link & 1;
   }
 
-  template <class T, class Compare>
-  T& radix<T,Compare>::at(const key_type& key){
-    return const_cast<T&>(std::as_const(*this).at(key));
+  template <class NodePtr>
+  void Link<NodePtr,true>::Copy(const type* first, const type* last, type* dest) noexcept {
+    for (; first != last; ++first, ++dest){
+      Store(*dest, Load(*first));
+    }
   }
 
-  template <class T, class Compare>
-  const T& radix<T,Compare>::at(const key_type& key) const {
-    const_node_ptr node = m_root->Retrieve(key);
-    if (node == nullptr || !node->IsLeaf()){
-      throw std::out_of_range("radix::at:  key not found");
+  template <class NodePtr>
+  void Link<NodePtr,true>::CopyBackward(const type* first, const type* last, type* dest_last) noexcept {
+    while (first != last){
+      Store(*--dest_last, Load(*--last));
     }
-    return m_root->Retrieve(key)->m_value_pair.second;
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::find(const key_type& key){
-    node_ptr node = m_root->Retrieve(key);
-    return (node->IsLeaf()? iterator(node) : end());
+
+  ///////////////
+  // CHILD MAP //
+  ///////////////
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  Child_map<NodePtr,ByteOrdered,Compact>::Child_map() noexcept : m_kind(Kind::node4), m_count(0), m_inline_bytes(), m_storage() {}
+
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  size_t Child_map<NodePtr,ByteOrdered,Compact>::size() const noexcept {
+    return m_count;
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_iterator radix<T,Compare>::find(const key_type& key) const {
-    node_ptr node = m_root->Retrieve(key);
-    return (node->IsLeaf()? const_iterator(node) : cend());
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  bool Child_map<NodePtr,ByteOrdered,Compact>::empty() const noexcept {
+    return !m_count;
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::iterator radix<T,Compare>::find(const K& key){
-    iterator it = lower_bound(key);
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  NodePtr Child_map<NodePtr,ByteOrdered,Compact>::Find(unsigned char byte) const {
+    switch (m_kind){
+      case Kind::node48:{
+        unsigned char slot = m_storage.node48->index[byte];
+        return slot? link::Load(m_storage.node48->children[slot-1]) : nullptr;
+      }
+      case Kind::node256:
+        return link::Load(m_storage.node256->children[byte]);
+      default:{
+        size_t pos = Position(byte);
+        return pos != m_count? ChildAt(pos) : nullptr;
+      }
+    }
+  }
 
-    const Compare comp;
-    return (it != end() && !comp(it->first, key) && !comp(key, it->first))? it : end();
+  // Returns the position of the child with the given byte, or size() if there is none
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  size_t Child_map<NodePtr,ByteOrdered,Compact>::Position(unsigned char byte) const {
+    switch (m_kind){
+      case Kind::node4:
+        for (size_t i = 0; i < m_count; ++i){
+          if (m_inline_bytes[i] == byte){
+            return i;
+          }
+        }
+        return m_count;
+      case Kind::node16:{
+#if defined(__SSE2__)
+        __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_storage.node16->bytes)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << m_count) - 1);
+        return mask? std::countr_zero(mask) : m_count;
+#else
+        const unsigned char* bytes = m_storage.node16->bytes;
+        return std::find(bytes, bytes + m_count, byte) - bytes;
+#endif
+      }
+      case Kind::node48:
+        if (!m_storage.node48->index[byte]){
+          return m_count;
+        }
+        break;
+      case Kind::node256:
+        if (!m_storage.node256->children[byte]){
+          return m_count;
+        }
+        break;
+    }
+    // The byte is present, search the order
+    const unsigned char* order = Order();
+    if constexpr (ByteOrdered){
+      return std::lower_bound(order, order + m_count, byte) - order;
+    }
+    else {
+      return std::find(order, order + m_count, byte) - order;
+    }
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::const_iterator radix<T,Compare>::find(const K& key) const {
-    const_iterator it = lower_bound(key);
+  // Returns the position of the first child whose byte is not smaller than the given byte.
+  // Only meaningful if the children are ordered by their bytes.
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  size_t Child_map<NodePtr,ByteOrdered,Compact>::LowerPosition(unsigned char byte) const {
+    static_assert(ByteOrdered, "Child_map::LowerPosition requires children ordered by byte");
+    const unsigned char* order = Order();
+    return std::lower_bound(order, order + m_count, byte) - order;
+  }
 
-    Compare comp;
-    return (it != cend() && !comp(it->first, key) && !comp(key, it->first))? it : cend();
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  unsigned char Child_map<NodePtr,ByteOrdered,Compact>::ByteAt(size_t pos) const {
+    return Order()[pos];
   }
 
-  /////////////////
-  // LOWER BOUND //
-  /////////////////
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  NodePtr Child_map<NodePtr,ByteOrdered,Compact>::ChildAt(size_t pos) const {
+    switch (m_kind){
+      case Kind::node4:
+        return link::Load(m_storage.node4.children[pos]);
+      case Kind::node16:
+        return link::Load(m_storage.node16->children[pos]);
+      case Kind::node48:
+        return link::Load(m_storage.node48->children[m_storage.node48->index[m_storage.node48->order[pos]]-1]);
+      default:
+        return link::Load(m_storage.node256->children[m_storage.node256->order[pos]]);
+    }
+  }
 
-  // Condition for finding first item that is not smaller than key
-  // Used in lower_bound
-  template <class T, class Compare> template <class K>
-  bool radix<T,Compare>::conditionLower(const key_type& tree_key, const K& key){
-    const Compare comp;
-    return !comp(tree_key,key);
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  NodePtr Child_map<NodePtr,ByteOrdered,Compact>::Front() const {
+    return ChildAt(0);
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::lower_bound(const key_type& key){
-    return iterator(m_root->FindCondition(radix::conditionLower<key_type>, key));
+
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  NodePtr Child_map<NodePtr,ByteOrdered,Compact>::Back() const {
+    return ChildAt(m_count-1);
+  }
+
+  // Inserts a child at the given position in the order. The byte must not be present yet.
+  template <class NodePtr, bool ByteOrdered, bool Compact> template <class Alloc>
+  void Child_map<NodePtr,ByteOrdered,Compact>::Insert(size_t pos, unsigned char byte, NodePtr child, const Alloc& alloc){
+    if (m_count == Capacity()){
+      Rebuild(static_cast<Kind>(static_cast<unsigned char>(m_kind) + 1), alloc);
+    }
+
+    switch (m_kind){
+      case Kind::node4:{
+        Node4& node = m_storage.node4;
+        std::copy_backward(m_inline_bytes + pos, m_inline_bytes + m_count, m_inline_bytes + m_count + 1);
+        link::CopyBackward(node.children + pos, node.children + m_count, node.children + m_count + 1);
+        m_inline_bytes[pos] = byte;
+        link::Store(node.children[pos], child);
+        break;
+      }
+      case Kind::node16:{
+        Node16& node = *m_storage.node16;
+        std::copy_backward(node.bytes + pos, node.bytes + m_count, node.bytes + m_count + 1);
+        link::CopyBackward(node.children + pos, node.children + m_count, node.children + m_count + 1);
+        node.bytes[pos] = byte;
+        link::Store(node.children[pos], child);
+        break;
+      }
+      case Kind::node48:{
+        Node48& node = *m_storage.node48;
+        // Slots are not ordered, take the first unused one
+        unsigned char slot = 0;
+        while (node.children[slot]){
+          ++slot;
+        }
+        link::Store(node.children[slot], child);
+        node.index[byte] = slot + 1;
+        std::copy_backward(node.order + pos, node.order + m_count, node.order + m_count + 1);
+        node.order[pos] = byte;
+        break;
+      }
+      case Kind::node256:{
+        Node256& node = *m_storage.node256;
+        link::Store(node.children[byte], child);
+        std::copy_backward(node.order + pos, node.order + m_count, node.order + m_count + 1);
+        node.order[pos] = byte;
+        break;
+      }
+    }
+    ++m_count;
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_iterator radix<T,Compare>::lower_bound(const key_type& key) const {
-    return const_iterator(m_root->FindCondition(radix::conditionLower<key_type>, key));
+  template <class NodePtr, bool ByteOrdered, bool Compact> template <class Alloc>
+  void Child_map<NodePtr,ByteOrdered,Compact>::Erase(size_t pos, const Alloc& alloc) noexcept {
+    switch (m_kind){
+      case Kind::node4:{
+        Node4& node = m_storage.node4;
+        std::copy(m_inline_bytes + pos + 1, m_inline_bytes + m_count, m_inline_bytes + pos);
+        link::Copy(node.children + pos + 1, node.children + m_count, node.children + pos);
+        break;
+      }
+      case Kind::node16:{
+        Node16& node = *m_storage.node16;
+        std::copy(node.bytes + pos + 1, node.bytes + m_count, node.bytes + pos);
+        link::Copy(node.children + pos + 1, node.children + m_count, node.children + pos);
+        break;
+      }
+      case Kind::node48:{
+        Node48& node = *m_storage.node48;
+        unsigned char byte = node.order[pos];
+        link::Store(node.children[node.index[byte]-1], nullptr);
+        node.index[byte] = 0;
+        std::copy(node.order + pos + 1, node.order + m_count, node.order + pos);
+        break;
+      }
+      case Kind::node256:{
+        Node256& node = *m_storage.node256;
+        link::Store(node.children[node.order[pos]], nullptr);
+        std::copy(node.order + pos + 1, node.order + m_count, node.order + pos);
+        break;
+      }
+    }
+    --m_count;
+
+    // Shrink with some slack, so that alternating insertion and removal at a size boundary
+    // does not rebuild the map every time. Rebuild() leaves the map unchanged if it fails.
+    try {
+      switch (m_kind){
+        case Kind::node16:
+          if (m_count <= 3) { Rebuild(Kind::node4, alloc); }
+          break;
+        case Kind::node48:
+          if (m_count <= 12) { Rebuild(Kind::node16, alloc); }
+          break;
+        case Kind::node256:
+          if (m_count <= 40) { Rebuild(Kind::node48, alloc); }
+          break;
+        default:
+          break;
+      }
+    }
+    catch (...) {}
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::iterator radix<T,Compare>::lower_bound(const K& key){
-    return iterator(m_root->FindCondition(radix::conditionLower, key));
+  // Puts another child at the position, its edge label must start with the same byte
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  void Child_map<NodePtr,ByteOrdered,Compact>::Replace(size_t pos, NodePtr child) noexcept {
+    switch (m_kind){
+      case Kind::node4:
+        link::Store(m_storage.node4.children[pos], child);
+        break;
+      case Kind::node16:
+        link::Store(m_storage.node16->children[pos], child);
+        break;
+      case Kind::node48:
+        link::Store(m_storage.node48->children[m_storage.node48->index[m_storage.node48->order[pos]]-1], child);
+        break;
+      case Kind::node256:
+        link::Store(m_storage.node256->children[m_storage.node256->order[pos]], child);
+        break;
+    }
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::const_iterator radix<T,Compare>::lower_bound(const K& key) const {
-    return const_iterator(m_root->FindCondition(radix::conditionLower, key));
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  void Child_map<NodePtr,ByteOrdered,Compact>::swap(Child_map& other) noexcept {
+    if constexpr (Compact){
+      // Inline links are relative to the map that stores them, so they are stored again
+      NodePtr children[4];
+      NodePtr other_children[4];
+      for (size_t i = 0; m_kind == Kind::node4 && i < m_count; ++i){
+        children[i] = ChildAt(i);
+      }
+      for (size_t i = 0; other.m_kind == Kind::node4 && i < other.m_count; ++i){
+        other_children[i] = other.ChildAt(i);
+      }
+      std::swap(m_kind, other.m_kind);
+      std::swap(m_count, other.m_count);
+      std::swap(m_inline_bytes, other.m_inline_bytes);
+      std::swap(m_storage, other.m_storage);
+      for (size_t i = 0; m_kind == Kind::node4 && i < m_count; ++i){
+        link::Store(m_storage.node4.children[i], other_children[i]);
+      }
+      for (size_t i = 0; other.m_kind == Kind::node4 && i < other.m_count; ++i){
+        link::Store(other.m_storage.node4.children[i], children[i]);
+      }
+    }
+    else {
+      std::swap(m_kind, other.m_kind);
+      std::swap(m_count, other.m_count);
+      std::swap(m_inline_bytes, other.m_inline_bytes);
+      std::swap(m_storage, other.m_storage);
+    }
   }
 
-  /////////////////
-  // UPPER BOUND //
-  /////////////////
-  
-  // Condition for finding first item that is greater than key
-  // Used in upper_bound
-  template <class T, class Compare> template <class K>
-  bool radix<T,Compare>::conditionUpper(const key_type& tree_key, const K& key){
-    Compare comp;
-    return comp(key, tree_key);
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  size_t Child_map<NodePtr,ByteOrdered,Compact>::Capacity() const {
+    switch (m_kind){
+      case Kind::node4: return 4;
+      case Kind::node16: return 16;
+      case Kind::node48: return 48;
+      default: return 256;
+    }
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator radix<T,Compare>::upper_bound(const key_type& key){
-    return iterator(m_root->FindCondition(radix::conditionUpper<key_type>, key));
+
+  // Bytes of the children in iteration order
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  const unsigned char* Child_map<NodePtr,ByteOrdered,Compact>::Order() const {
+    switch (m_kind){
+      case Kind::node4: return m_inline_bytes;
+      case Kind::node16: return m_storage.node16->bytes;
+      case Kind::node48: return m_storage.node48->order;
+      default: return m_storage.node256->order;
+    }
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_iterator radix<T,Compare>::upper_bound(const key_type& key) const {
-    return const_iterator(m_root->FindCondition(radix::conditionUpper<key_type>, key));
+  // Moves all children into a layout of the given kind, which must be able to hold them
+  template <class NodePtr, bool ByteOrdered, bool Compact> template <class Alloc>
+  void Child_map<NodePtr,ByteOrdered,Compact>::Rebuild(Kind kind, const Alloc& alloc){
+    // Allocate first, so that the map is left unchanged if the allocation fails
+    Storage storage;
+    switch (kind){
+      case Kind::node4:
+        storage.node4 = Node4();
+        break;
+      case Kind::node16:
+        storage.node16 = ::new (static_cast<void*>(Allocate<Node16>(alloc))) Node16();
+        break;
+      case Kind::node48:
+        storage.node48 = ::new (static_cast<void*>(Allocate<Node48>(alloc))) Node48();
+        break;
+      case Kind::node256:
+        storage.node256 = ::new (static_cast<void*>(Allocate<Node256>(alloc))) Node256();
+        break;
+    }
+
+    unsigned char bytes[256];
+    NodePtr children[256];
+    const size_t count = m_count;
+    for (size_t i = 0; i < count; ++i){
+      bytes[i] = ByteAt(i);
+      children[i] = ChildAt(i);
+    }
+
+    Release(alloc);
+    m_kind = kind;
+    m_storage = storage;
+    for (size_t i = 0; i < count; ++i){
+      Insert(i, bytes[i], children[i], alloc);
+    }
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::iterator radix<T,Compare>::upper_bound(const K& key){
-    return iterator(m_root->FindCondition(radix::conditionUpper, key));
+  // Frees the storage of the map and leaves it empty
+  template <class NodePtr, bool ByteOrdered, bool Compact> template <class Alloc>
+  void Child_map<NodePtr,ByteOrdered,Compact>::Release(const Alloc& alloc) noexcept {
+    switch (m_kind){
+      case Kind::node16: Deallocate(m_storage.node16, alloc); break;
+      case Kind::node48: Deallocate(m_storage.node48, alloc); break;
+      case Kind::node256: Deallocate(m_storage.node256, alloc); break;
+      default: break;
+    }
+    m_kind = Kind::node4;
+    m_count = 0;
+    m_storage = Storage();
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::const_iterator radix<T,Compare>::upper_bound(const K& key) const {
-    return const_iterator(m_root->FindCondition(radix::conditionUpper, key));
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  typename Child_map<NodePtr,ByteOrdered,Compact>::const_iterator Child_map<NodePtr,ByteOrdered,Compact>::begin() const {
+    return const_iterator(this, 0);
   }
 
-  /////////////////
-  // EQUAL RANGE //
-  /////////////////
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  typename Child_map<NodePtr,ByteOrdered,Compact>::const_iterator Child_map<NodePtr,ByteOrdered,Compact>::end() const {
+    return const_iterator(this, m_count);
+  }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::iterator_pair radix<T,Compare>::equal_range(const key_type& key)
-  {
-    iterator lb = lower_bound(key);
-    iterator ub;
-    for (ub = lb; ub != cend() && !radix::conditionUpper(ub->first,key); ++ub){}
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  Child_map<NodePtr,ByteOrdered,Compact>::const_iterator::const_iterator(const Child_map* map, size_t pos) 
+    : m_map(map), m_pos(pos) {}
 
-    return std::make_pair(lb, ub);
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  NodePtr Child_map<NodePtr,ByteOrdered,Compact>::const_iterator::operator*() const {
+    return m_map->ChildAt(m_pos);
   }
 
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_iterator_pair radix<T,Compare>::equal_range(const key_type& key) const
-  {
-    const_iterator lb = lower_bound(key);
-    const_iterator ub;
-    for (ub = lb; ub != cend() && !radix::conditionUpper(ub->first,key); ++ub){}
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  typename Child_map<NodePtr,ByteOrdered,Compact>::const_iterator& Child_map<NodePtr,ByteOrdered,Compact>::const_iterator::operator++(){
+    ++m_pos;
+    return *this;
+  }
 
-    return std::make_pair(lb, ub);
+  template <class NodePtr, bool ByteOrdered, bool Compact>
+  bool Child_map<NodePtr,ByteOrdered,Compact>::const_iterator::operator!=(const const_iterator& other) const {
+    return m_pos != other.m_pos;
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::iterator_pair radix<T,Compare>::equal_range(const K& key)
-  {
-    iterator lb = lower_bound(key);
-    iterator ub;
-    for (ub = lb; ub != cend() && !radix::conditionUpper(ub->first,key); ++ub){}
+  ////////////////
+  // HASH INDEX //
+  ////////////////
+  template <class NodePtr, bool Compact, class Hash>
+  Hash_index<NodePtr,Compact,Hash>::Hash_index() noexcept : m_slots(nullptr), m_capacity(0), m_size(0), m_hasher() {}
 
-    return std::make_pair(lb, ub);
+  template <class NodePtr, bool Compact, class Hash>
+  NodePtr Hash_index<NodePtr,Compact,Hash>::Find(std::string_view key) const {
+    if (!m_size){
+      return nullptr;
+    }
+    const size_t hash = m_hasher(key);
+    const size_t mask = m_capacity - 1;
+    for (size_t pos = hash & mask;; pos = (pos + 1) & mask){
+      NodePtr node = link::Load(m_slots[pos].node);
+      if (!node){
+        return nullptr;
+      }
+      if (m_slots[pos].hash == hash && std::string_view(node->GetKey()) == key){
+        return node;
+      }
+    }
   }
 
-  template <class T, class Compare> template <class K>
-  typename radix<T,Compare>::const_iterator_pair radix<T,Compare>::equal_range(const K& key) const
-  {
-    const_iterator lb = lower_bound(key);
-    const_iterator ub;
-    for (ub = lb; ub != cend() && !radix::conditionUpper(ub->first,key); ++ub){}
+  // Makes room for the given number of elements, the stored hashes are reused when the slots are
+  // distributed over the larger table
+  template <class NodePtr, bool Compact, class Hash> template <class Alloc>
+  void Hash_index<NodePtr,Compact,Hash>::Reserve(size_t count, const Alloc& alloc){
+    if (count * 4 <= m_capacity * 3){
+      return;
+    }
+    size_t capacity = std::max(min_capacity, m_capacity);
+    while (count * 4 > capacity * 3){
+      capacity *= 2;
+    }
 
-    return std::make_pair(lb, ub);
+    Slot* slots = Allocate<Slot>(alloc, capacity);
+    for (size_t pos = 0; pos < capacity; ++pos){
+      ::new (static_cast<void*>(slots + pos)) Slot();
+    }
+    std::swap(slots, m_slots);
+    std::swap(capacity, m_capacity);
+    for (size_t pos = 0; pos < capacity; ++pos){
+      if (NodePtr node = link::Load(slots[pos].node)){
+        Place(slots[pos].hash, node);
+      }
+    }
+    if (slots){
+      Deallocate(slots, alloc, capacity);
+    }
   }
 
-  template <class T, class Compare>
-  T& radix<T,Compare>::operator[](const key_type& key){
-    return insert(std::make_pair(key, T())).first->second;
+  template <class NodePtr, bool Compact, class Hash>
+  void Hash_index<NodePtr,Compact,Hash>::Insert(NodePtr node) noexcept {
+    assert((m_size + 1) * 4 <= m_capacity * 3);
+    Place(m_hasher(std::string_view(node->GetKey())), node);
+    ++m_size;
   }
 
-  template <class T, class Compare>
-  typename xsm::radix<T,Compare>::size_type xsm::radix<T,Compare>::count(const key_type& key) const {
-    return contains(key)? 1 : 0;
+  template <class NodePtr, bool Compact, class Hash>
+  void Hash_index<NodePtr,Compact,Hash>::Place(size_t hash, NodePtr node) noexcept {
+    const size_t mask = m_capacity - 1;
+    size_t pos = hash & mask;
+    while (link::Load(m_slots[pos].node)){
+      pos = (pos + 1) & mask;
+    }
+    m_slots[pos].hash = hash;
+    link::Store(m_slots[pos].node, node);
   }
-  
-  template <class T, class Compare> template <class K>
-  typename xsm::radix<T,Compare>::size_type xsm::radix<T,Compare>::count(const K& key) const {
 
-    size_type i = 0;
-    for (auto it = lower_bound(key); it != cend() && !radix::conditionUpper(it->first,key); ++it){
-      ++i;
+  // Removes the node and moves each following slot of the probe sequence into the gap, unless its
+  // hash places it after the gap
+  template <class NodePtr, bool Compact, class Hash>
+  void Hash_index<NodePtr,Compact,Hash>::Erase(NodePtr node) noexcept {
+    const size_t mask = m_capacity - 1;
+    size_t gap = m_hasher(std::string_view(node->GetKey())) & mask;
+    while (link::Load(m_slots[gap].node) != node){
+      gap = (gap + 1) & mask;
     }
-    return i;
 
+    for (size_t pos = (gap + 1) & mask; NodePtr next = link::Load(m_slots[pos].node); pos = (pos + 1) & mask){
+      const size_t home = m_slots[pos].hash & mask;
+      if (((pos - home) & mask) >= ((pos - gap) & mask)){
+        m_slots[gap].hash = m_slots[pos].hash;
+        link::Store(m_slots[gap].node, next);
+        gap = pos;
+      }
+    }
+    link::Store(m_slots[gap].node, nullptr);
+    --m_size;
   }
 
-  template <class T, class Compare>
-  bool radix<T,Compare>::contains(const key_type& key) const {
-    const_node_ptr node = m_root->Retrieve(key);
-    return (node != nullptr && node->IsLeaf());
+  template <class NodePtr, bool Compact, class Hash> template <class Alloc>
+  void Hash_index<NodePtr,Compact,Hash>::Release(const Alloc& alloc) noexcept {
+    if (m_slots){
+      Deallocate(m_slots, alloc, m_capacity);
+    }
+    m_slots = nullptr;
+    m_capacity = 0;
+    m_size = 0;
   }
 
-  template <class T, class Compare> template <class K>
-  bool radix<T,Compare>::contains(const K& key) const {
-    return (find(key) != cend());
-  }
-  
-  template <class T, class Compare>
-  detail::Iterator_impl<T,Compare> radix<T,Compare>::begin() noexcept {
-    // need to increment because the root node is not a leaf node
-    return ++iterator(m_root);
-  }
-  
-  template <class T, class Compare>
-  detail::Iterator_impl<T,Compare,const T> radix<T,Compare>::begin() const noexcept {
-    return cbegin();
-  }
-  
-  template <class T, class Compare>
-  detail::Iterator_impl<T,Compare> radix<T,Compare>::end() noexcept {
-    return iterator(m_root);
-  }
-  
-  template <class T, class Compare>
-  detail::Iterator_impl<T,Compare,const T> radix<T,Compare>::end() const noexcept {
-    return cend();
-  }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::reverse_iterator radix<T,Compare>::rbegin() noexcept {
-    return reverse_iterator(end());
+  template <class NodePtr, bool Compact, class Hash>
+  void Hash_index<NodePtr,Compact,Hash>::swap(Hash_index& other) noexcept {
+    std::swap(m_slots, other.m_slots);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_size, other.m_size);
+    std::swap(m_hasher, other.m_hasher);
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_reverse_iterator radix<T,Compare>::rbegin() const noexcept {
-    return crbegin();
+
+  //////////////////
+  // LOOKUP CACHE //
+  //////////////////
+  template <class NodePtr, bool Compact, size_t Entries>
+  Lookup_cache<NodePtr,Compact,Entries>::Lookup_cache() noexcept : hits(0), misses(0), m_slots(nullptr) {}
+
+  template <class NodePtr, bool Compact, size_t Entries>
+  size_t Lookup_cache<NodePtr,Compact,Entries>::Hash(std::string_view key) noexcept {
+    return std::hash<std::string_view>()(key);
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::reverse_iterator radix<T,Compare>::rend() noexcept {
-    return reverse_iterator(begin());
+
+  template <class NodePtr, bool Compact, size_t Entries>
+  NodePtr Lookup_cache<NodePtr,Compact,Entries>::Find(std::string_view key, size_t hash) noexcept {
+    if (m_slots){
+      const Slot& slot = m_slots[hash & (Entries - 1)];
+      NodePtr node = link::Load(slot.node);
+      if (node && slot.hash == hash && std::string_view(node->GetKey()) == key){
+        ++hits;
+        return node;
+      }
+    }
+    ++misses;
+    return nullptr;
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_reverse_iterator radix<T,Compare>::rend() const noexcept {
-    return crend();
+
+  template <class NodePtr, bool Compact, size_t Entries>
+  void Lookup_cache<NodePtr,Compact,Entries>::Store(size_t hash, NodePtr node) noexcept {
+    if (m_slots){
+      Slot& slot = m_slots[hash & (Entries - 1)];
+      slot.hash = hash;
+      link::Store(slot.node, node);
+    }
   }
 
-  template <class T, class Compare>
-  detail::Iterator_impl<T,Compare,const T> radix<T,Compare>::cbegin() const noexcept {
-    return ++const_iterator(m_root);
+  // Only the slot of the key of the node can refer to it
+  template <class NodePtr, bool Compact, size_t Entries>
+  void Lookup_cache<NodePtr,Compact,Entries>::Erase(NodePtr node) noexcept {
+    if (m_slots){
+      Slot& slot = m_slots[Hash(node->GetKey()) & (Entries - 1)];
+      if (link::Load(slot.node) == node){
+        link::Store(slot.node, nullptr);
+      }
+    }
   }
-  
-  template <class T, class Compare>
-  detail::Iterator_impl<T,Compare,const T> radix<T,Compare>::cend() const noexcept {
-    return const_iterator(m_root);
+
+  // Forgets all leaves, e.g. when many of them leave the tree at once
+  template <class NodePtr, bool Compact, size_t Entries>
+  void Lookup_cache<NodePtr,Compact,Entries>::Clear() noexcept {
+    for (size_t pos = 0; m_slots && pos < Entries; ++pos){
+      link::Store(m_slots[pos].node, nullptr);
+    }
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_reverse_iterator radix<T,Compare>::crbegin() const noexcept {
-    return const_reverse_iterator(end());
+
+  template <class NodePtr, bool Compact, size_t Entries> template <class Alloc>
+  void Lookup_cache<NodePtr,Compact,Entries>::Allocate(const Alloc& alloc){
+    if (!m_slots){
+      Slot* slots = detail::Allocate<Slot>(alloc, Entries);
+      for (size_t pos = 0; pos < Entries; ++pos){
+        ::new (static_cast<void*>(slots + pos)) Slot();
+      }
+      m_slots = slots;
+    }
   }
-  
-  template <class T, class Compare>
-  typename radix<T,Compare>::const_reverse_iterator radix<T,Compare>::crend() const noexcept {
-    return const_reverse_iterator(begin());
+
+  template <class NodePtr, bool Compact, size_t Entries> template <class Alloc>
+  void Lookup_cache<NodePtr,Compact,Entries>::Release(const Alloc& alloc) noexcept {
+    if (m_slots){
+      Deallocate(m_slots, alloc, Entries);
+      m_slots = nullptr;
+    }
   }
-  
-  template <class T, class Compare>
-  void radix<T,Compare>::print() const {
-    std::cout << "ROOT";
-    m_root->print();
-    std::cout << "\n" << std::flush;
+
+  // The slots refer to the nodes of a tree and are exchanged with it, the counters stay
+  template <class NodePtr, bool Compact, size_t Entries>
+  void Lookup_cache<NodePtr,Compact,Entries>::swap(Lookup_cache& other) noexcept {
+    std::swap(m_slots, other.m_slots);
   }
-}
 
-namespace xsm::detail{ 
   //////////////
   // ITERATOR //
   //////////////
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType>::Iterator_impl() : m_node(nullptr) {}
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType>::Iterator_impl() : m_node(nullptr), m_position(unknown_position), m_root(nullptr) {}
   
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType>::Iterator_impl(node_ptr ptr) : m_node(ptr) {}
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType>::Iterator_impl(node_ptr ptr, size_t position) 
+    : m_node(ptr), m_position(position), m_root(nullptr) {}
+
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType> Iterator_impl<T,Compare,Allocator,Options,ItType>::End(const node_ptr& root){
+    Iterator_impl<T,Compare,Allocator,Options,ItType> it;
+    it.m_root = &root;
+    return it;
+  }
+
+  // Returns the node the iterator points to, which is the current root for end()
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  typename Iterator_impl<T,Compare,Allocator,Options,ItType>::node_ptr Iterator_impl<T,Compare,Allocator,Options,ItType>::GetNode() const {
+    return (m_node || !m_root)? m_node : *m_root;
+  }
  
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType>& Iterator_impl<T,Compare,ItType>::operator++(){
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType>& Iterator_impl<T,Compare,Allocator,Options,ItType>::operator++(){
+    m_node = GetNode();
+    if constexpr (Node<T,Compare,Allocator,Options>::leaf_links){
+      if (m_node->IsLeaf()){
+        node_ptr next = m_node->GetNextLeaf();
+        if (next){
+          m_node = next;
+          m_position = unknown_position;
+          return *this;
+        }
+      }
+    }
     // Advance iterator until you reach a leaf node
     while (Advance()) {}
     return *this;
   }
 
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType> Iterator_impl<T,Compare,ItType>::operator++(int){
-    Iterator_impl<T,Compare,ItType> temp = *this;
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType> Iterator_impl<T,Compare,Allocator,Options,ItType>::operator++(int){
+    Iterator_impl<T,Compare,Allocator,Options,ItType> temp = *this;
     ++*this;
     return temp;
   }
 
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType>& Iterator_impl<T,Compare,ItType>::operator--(){
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType>& Iterator_impl<T,Compare,Allocator,Options,ItType>::operator--(){
+    m_node = GetNode();
+    if constexpr (Node<T,Compare,Allocator,Options>::leaf_links){
+      if (m_node->IsLeaf()){
+        node_ptr prev = m_node->GetPrevLeaf();
+        if (prev){
+          m_node = prev;
+          m_position = unknown_position;
+          return *this;
+        }
+      }
+    }
     // Regress iterator until you reach a leaf node
     while (Regress()) {}
     return *this;
   }
 
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType> Iterator_impl<T,Compare,ItType>::operator--(int){
-    Iterator_impl<T,Compare,ItType> temp = *this;
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType> Iterator_impl<T,Compare,Allocator,Options,ItType>::operator--(int){
+    Iterator_impl<T,Compare,Allocator,Options,ItType> temp = *this;
     --*this;
     return temp;
   }
 
-  template <class T, class Compare, class ItType>
-  typename Iterator_impl<T,Compare,ItType>::reference Iterator_impl<T,Compare,ItType>::operator*() const {
-    return m_node->m_value_pair;
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  typename Iterator_impl<T,Compare,Allocator,Options,ItType>::reference Iterator_impl<T,Compare,Allocator,Options,ItType>::operator*() const {
+    return m_node->GetValuePair();
   }
 
-  template <class T, class Compare, class ItType>
-  typename Iterator_impl<T,Compare,ItType>::pointer Iterator_impl<T,Compare,ItType>::operator->() const {
-    return &m_node->m_value_pair;
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  typename Iterator_impl<T,Compare,Allocator,Options,ItType>::pointer Iterator_impl<T,Compare,Allocator,Options,ItType>::operator->() const {
+    return &m_node->GetValuePair();
   }
 
   // conversion iterator to const_iterator
-  template <class T, class Compare, class ItType>
-  Iterator_impl<T,Compare,ItType>::operator const_iterator() const {
-    return Iterator_impl<T,Compare,const T>(m_node);
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  Iterator_impl<T,Compare,Allocator,Options,ItType>::operator const_iterator() const {
+    Iterator_impl<T,Compare,Allocator,Options,const T> it(m_node, m_position);
+    it.m_root = m_root;
+    return it;
   }
 
-  std::string StrDiff(const std::string& fullstr, const std::string& substr){
-    auto last_match = std::mismatch(fullstr.begin(), fullstr.end(), substr.begin(), substr.end());
-    return std::string(last_match.first, fullstr.end());
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  size_t Iterator_impl<T,Compare,Allocator,Options,ItType>::PositionInParent(const child_map& siblings) const {
+    if (m_position < siblings.size() && siblings.ChildAt(m_position) == m_node){
+      return m_position;
+    }
+    return siblings.Position(m_node->GetEdgeByte());
   }
 
   // Advances iterator forward by one. Returns true if the iterator lands on a non-leaf node
-  template <class T, class Compare, class ItType>
-  bool Iterator_impl<T,Compare,ItType>::Advance(){
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  bool Iterator_impl<T,Compare,Allocator,Options,ItType>::Advance(){
 
     // If node has children, go to first child in sequence
     if (!m_node->IsChildless()){
       m_node = m_node->GetFirstChild();
+      m_position = 0;
       return !m_node->IsLeaf();
     }
 
     // Until we reach the root node
-    while (!m_node->GetKey().empty()){
-      // If node has no children, then go up to parent and remember child
-      key_type prev_child = m_node->GetKey();
-      m_node = m_node->GetParent();
-
-      // Find next child 
-      key_type key = StrDiff(prev_child, m_node->GetKey());
-      auto it = m_node->GetChildren().find(key);
-      ++it;
-      if (it != m_node->GetChildren().end()){
-        m_node = it->second;
+    while (m_node->GetParent()){
+      // If node has no children, then go up to parent and find the next sibling
+      const child_map& siblings = m_node->GetParent()->GetChildren();
+      size_t pos = PositionInParent(siblings) + 1;
+      if (pos < siblings.size()){
+        m_node = siblings.ChildAt(pos);
+        m_position = pos;
         return !m_node->IsLeaf();
       }
+      m_node = m_node->GetParent();
+      m_position = unknown_position;
     }
-    // Cannot advance anymore, nullptr reached
+    // Cannot advance anymore, root reached
     return false;
   }
 
-  template <class T, class Compare, class ItType>
-  bool Iterator_impl<T,Compare,ItType>::Regress(){
+  template <class T, class Compare, class Allocator, class Options, class ItType>
+  bool Iterator_impl<T,Compare,Allocator,Options,ItType>::Regress(){
     if (m_node->GetParent()){
       // Check whether this node has younger siblings
       // younger == sorted before
-      key_type start_key = StrDiff(this->operator->()->first, m_node->GetParent()->GetKey());
-      auto it = m_node->GetParent()->GetChildren().find(start_key);
+      const child_map& siblings = m_node->GetParent()->GetChildren();
+      size_t pos = PositionInParent(siblings);
       // This node has no younger siblings
-      if (it == m_node->GetParent()->GetChildren().begin()){
+      if (pos == 0){
         m_node = m_node->GetParent();
+        m_position = unknown_position;
         return !m_node->IsLeaf();
       }
-      m_node = (--it)->second;
+      m_node = siblings.ChildAt(pos-1);
+      m_position = pos-1;
     }
     while (!m_node->GetChildren().empty()){
-      m_node = m_node->GetChildren().rbegin()->second;
+      m_position = m_node->GetChildren().size() - 1;
+      m_node = m_node->GetChildren().Back();
     }
     return !m_node->IsLeaf();
   }
   
-  template <class T, class Compare, class ItType, class ItType2>
-  bool operator==(const Iterator_impl<T,Compare,ItType>& lhs, const Iterator_impl<T,Compare,ItType2>& rhs){
-    return lhs.m_node == rhs.m_node;
+  template <class T, class Compare, class Allocator, class Options, class ItType, class ItType2>
+  bool operator==(const Iterator_impl<T,Compare,Allocator,Options,ItType>& lhs, const Iterator_impl<T,Compare,Allocator,Options,ItType2>& rhs){
+    return lhs.GetNode() == rhs.GetNode();
   }
 
-  template <class T, class Compare, class ItType, class ItType2>
-  bool operator!=(const Iterator_impl<T,Compare,ItType>& lhs, const Iterator_impl<T,Compare,ItType2>& rhs){
+  template <class T, class Compare, class Allocator, class Options, class ItType, class ItType2>
+  bool operator!=(const Iterator_impl<T,Compare,Allocator,Options,ItType>& lhs, const Iterator_impl<T,Compare,Allocator,Options,ItType2>& rhs){
     return !(lhs == rhs);
   }
   
@@ -1171,163 +4612,232 @@ namespace xsm::detail{
   // NODE //
   //////////
   // Constructors
-  template <class T, class Compare>
-  Node<T,Compare>::Node()
-    : m_is_leaf(false), 
-      m_value_pair(std::make_pair("",T())),
-      m_parent(nullptr),
-      m_children(child_map()) {}
-
-  template <class T, class Compare>
-  Node<T,Compare>::Node(node_ptr parent, value_type&& value_pair, const bool is_leaf)
-    : m_is_leaf(is_leaf),
-      m_value_pair(value_pair),
-      m_parent(parent),
-      m_children(child_map()) {}
- 
-  template <class T, class Compare> template <class... Args>
-  Node<T,Compare>::Node(node_ptr parent, const bool is_leaf, Args&&... args)
-    : m_is_leaf(is_leaf),
-      m_value_pair(value_type(std::forward<Args>(args)...)),
-      m_parent(parent),
-      m_children(child_map()) {}
+  template <class T, class Compare, class Allocator, class Options>
+  Node<T,Compare,Allocator,Options>::Node(const bool is_leaf)
+    : m_label(),
+      m_parent() {
+    link::Store(m_parent, nullptr, is_leaf);
+  }
 
-  // Destructor
-  // Each Node is responsible for deleting its children
-  template <class T, class Compare>
-  Node<T,Compare>::~Node(){
-    for (auto& entry : GetChildren()){
-      delete entry.second;
-    }
+  template <class T, class Compare, class Allocator, class Options> template <class... Args>
+  Leaf_node<T,Compare,Allocator,Options>::Leaf_node(Args&&... args)
+    : Node<T,Compare,Allocator,Options>(true),
+      m_links(),
+      m_value_pair(std::forward<Args>(args)...) {}
+
+  template <class T, class Compare, class Allocator, class Options>
+  Inner_node<T,Compare,Allocator,Options>::Inner_node()
+    : Node<T,Compare,Allocator,Options>(false) {}
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::NewInner(const allocator_type& alloc){
+    Inner_node<T,Compare,Allocator,Options>* node = Allocate<Inner_node<T,Compare,Allocator,Options>>(alloc);
+    return ::new (static_cast<void*>(node)) Inner_node<T,Compare,Allocator,Options>();
   }
 
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::Retrieve(const key_type& key) {
-    if (key.empty()){
-      return this;
+  // Root of all radix instances of this type that have not allocated a tree
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::EmptyRoot() noexcept {
+    static Inner_node<T,Compare,Allocator,Options> root;
+    return &root;
+  }
+
+  template <class T, class Compare, class Allocator, class Options> template <class... Args>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::NewLeaf(const allocator_type& alloc, Args&&... args){
+    Leaf_node<T,Compare,Allocator,Options>* node = Allocate<Leaf_node<T,Compare,Allocator,Options>>(alloc);
+    try {
+      return ::new (static_cast<void*>(node)) Leaf_node<T,Compare,Allocator,Options>(std::forward<Args>(args)...);
     }
-    auto first = key.begin();
-    auto key_end = key.end();
-    auto pos = first;
-    const child_map* children = &(this->GetChildren());
+    catch (...) {
+      Deallocate(node, alloc);
+      throw;
+    }
+  }
 
-    do {
-      ++pos;
-      key_type subkey(first,pos);
-      auto it = children->find(subkey);
+  // Deletes the node together with all of its descendants, and returns the number of deleted
+  // leaves. Nodes are not polymorphic, so deletion has to dispatch on the node type.
+  template <class T, class Compare, class Allocator, class Options>
+  size_t Node<T,Compare,Allocator,Options>::Delete(node_ptr node, const allocator_type& alloc) noexcept {
+    size_t count = 0;
+    for (node_ptr child : node->GetChildren()){
+      count += Delete(child, alloc);
+    }
+    node->GetChildren().Release(alloc);
+    node->m_label.Release(alloc);
+
+    if (node->IsLeaf()){
+      Leaf_node<T,Compare,Allocator,Options>* leaf = static_cast<Leaf_node<T,Compare,Allocator,Options>*>(node);
+      leaf->~Leaf_node();
+      Deallocate(leaf, alloc);
+      ++count;
+    }
+    else {
+      Inner_node<T,Compare,Allocator,Options>* inner = static_cast<Inner_node<T,Compare,Allocator,Options>*>(node);
+      inner->~Inner_node();
+      Deallocate(inner, alloc);
+    }
+    return count;
+  }
 
-      if (it != children->end()){
-        if (pos == key_end){
-          return it->second;
-        }
+  // Descends along the key without copying it, each byte of the key is compared once. Returns
+  // the node whose key extends the key of this node by the key, or nullptr if there is none.
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::Retrieve(std::string_view key) {
+    node_ptr node = this;
+
+    while (!key.empty()){
+      // Only the child whose edge label starts with the next byte can match
+      node_ptr child = node->GetChildren().Find(key.front());
+      if (!child){
+        return nullptr;
+      }
 
-        first = pos;
-        children = &(it->second->GetChildren());
+      // Edge label of child must be a prefix of the remaining key
+      std::string_view label = child->GetLabel();
+      if (!key.starts_with(label)){
+        return nullptr;
       }
-    } while (pos != key_end);
 
-    return this;
+      key.remove_prefix(label.size());
+      node = child;
+    }
+
+    return node;
   }
 
-  template <class T, class Compare>
-  size_t Node<T,Compare>::CountChildren() const {
+  template <class T, class Compare, class Allocator, class Options>
+  size_t Node<T,Compare,Allocator,Options>::CountChildren() const {
     return GetChildren().size();
   }
   
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::AddChild(const key_type& word, node_ptr node){
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::AddChild(const key_type& word, node_ptr node, const allocator_type& alloc){
     node->SetParent(this);
-    return GetChildren().emplace(word, node).first->second;
+    node->SetLabel(word, alloc);
+    GetChildren().Insert(ChildPosition(word), word.front(), node, alloc);
+    return node;
+  }
+
+  // Position at which a child with the given edge label is inserted, so that the children
+  // remain sorted by the comparator
+  template <class T, class Compare, class Allocator, class Options>
+  size_t Node<T,Compare,Allocator,Options>::ChildPosition(const key_type& word) const {
+    if constexpr (Is_lexicographic<key_compare>::value){
+      return GetChildren().LowerPosition(word.front());
+    }
+    else {
+      const key_compare comp;
+      size_t pos = 0;
+      for (const_node_ptr child : GetChildren()){
+        if (comp(word, key_type(child->GetLabel()))){
+          break;
+        }
+        ++pos;
+      }
+      return pos;
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::AddChild(const key_type& part, const allocator_type& alloc){
+    return AddChild(part, NewInner(alloc), alloc);
   }
 
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::AddChild(const key_type& part){
-    return AddChild(part, new Node(this, false, GetKey() + part, T()));
+  // Adds a child behind all other children, its edge label must order after theirs
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::AppendChild(std::string_view label, node_ptr node, const allocator_type& alloc){
+    node->SetParent(this);
+    node->SetLabel(label, alloc);
+    GetChildren().Insert(GetChildren().size(), label.front(), node, alloc);
+    return node;
   }
 
 
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::Extract(){
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::Extract(const allocator_type& alloc){
 
     if (CountChildren() == 0){
       // Store parent ptr so that this node can emancipate
       node_ptr parent = GetParent();
       // Cut ties with parent
-      Emancipate();
+      Emancipate(alloc);
       // Remove parent if they: 
       //  Are not a leaf node
       //  & Are childless
       //  & Are not the root node
-      if (!parent->IsLeaf() && parent->IsChildless() && !parent->GetKey().empty()){
-        delete parent->Extract();
+      if (!parent->IsLeaf() && parent->IsChildless() && parent->GetParent()){
+        Delete(parent->Extract(alloc), alloc);
       }
     }
     else if (CountChildren() == 1){
       // Store parent ptr so that this node can emancipate
       node_ptr parent = GetParent();
       // Cut ties with parent
-      Emancipate();
+      Emancipate(alloc);
       
-      // Child is adopted by parent
-      node_ptr orphan = GiveUpChild();
-      parent->Adopt(orphan); 
+      // Child is adopted by parent, the labels of this node and the child are joined
+      key_type label(GetLabel());
+      node_ptr orphan = GiveUpChild(alloc);
+      parent->Adopt(orphan, label.append(orphan->GetLabel()), alloc);
     }
     else {
-      // Create new node with same key as target but empty element
-      node_ptr empty_node = new Node(nullptr, false, GetKey(), mapped_type());
+      // Create new node that takes the place of the target but has an empty element
+      node_ptr empty_node = NewInner(alloc);
       
-      SubstituteWith(empty_node);
+      SubstituteWith(empty_node, alloc);
+    }
+    if constexpr (leaf_links){
+      if (IsLeaf()){
+        UnlinkLeaf();
+      }
     }
     return this;
   }
 
-  template <class T, class Compare>
-  void Node<T,Compare>::SubstituteWith(node_ptr empty_node){
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::SubstituteWith(node_ptr empty_node, const allocator_type& alloc){
     // Store parent ptr so that this node can emancipate
     node_ptr parent = GetParent();
     // Cut ties with parent
-    Emancipate();
+    Emancipate(alloc);
 
     // Let parent adopt new node
-    parent->Adopt(empty_node);
+    parent->Adopt(empty_node, key_type(GetLabel()), alloc);
 
     // Transfer children from target to new node
     empty_node->GetChildren().swap(GetChildren());
 
-    for (auto it : empty_node->GetChildren()){
-      it.second->SetParent(empty_node);
+    for (node_ptr child : empty_node->GetChildren()){
+      child->SetParent(empty_node);
     }
   }
   
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::GiveUpChild(){
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GiveUpChild(const allocator_type& alloc){
     // Extracts the first child of this node, severs the relation between child and this node,
     // and returns the orphaned node pointer
-    auto first_child_it = GetChildren().begin();
-    auto nh = GetChildren().extract(first_child_it);
-
-    node_ptr orphan = nh.mapped();
+    node_ptr orphan = GetChildren().Front();
+    GetChildren().Erase(0, alloc);
 
     orphan->RemoveParent();
     return orphan;
   }
 
-  template <class T, class Compare>
-  void Node<T,Compare>::RemoveParent(){
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::RemoveParent(){
     SetParent(nullptr);
   }
 
-  template <class T, class Compare>
-  void Node<T,Compare>::Adopt(node_ptr child){
-    const key_type str = StrDiff(child->GetKey(), GetKey());
-    AddChild(str, child);
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::Adopt(node_ptr child, const key_type& label, const allocator_type& alloc){
+    AddChild(label, child, alloc);
   }
 
-  template <class T, class Compare>
-  void Node<T,Compare>::Emancipate(){
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::Emancipate(const allocator_type& alloc){
     // Cut ties with parent
-    const key_type keydiff = StrDiff(GetKey(), GetParent()->GetKey());
-    GetParent()->GetChildren().erase(GetParent()->GetChildren().find(keydiff));
+    child_map& siblings = GetParent()->GetChildren();
+    siblings.Erase(siblings.Position(GetEdgeByte()), alloc);
     RemoveParent();
   }
 
@@ -1337,170 +4847,670 @@ namespace xsm::detail{
   // This function is used for both lower_bound() and upper_bound(). Each function specifies a
   // condition for finding the desired element as a function and passes it to FindCondition() as
   // a function pointer. The condition must strictly specify a key order, not just key equality.
-  template <class T, class Compare> template <class K>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::FindCondition(
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::FindCondition(
       bool(*condition)(const key_type&, const K&), const K& key){
 
-    node_ptr candidate_node = FindConditionNonLeaf(condition, key);
-
-    // Find first non-leaf node (candidate is not root)
-    if (!candidate_node->GetKey().empty()){
-      while (!candidate_node->IsLeaf()){
-        candidate_node = candidate_node->GetFirstChild();
-      }
-    }
-
-    return candidate_node;
+    return FindConditionNonLeaf(condition, key)->GetFirstLeaf();
   }
 
-  template <class T, class Compare> template <class K>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::FindConditionNonLeaf(
+  template <class T, class Compare, class Allocator, class Options> template <class K>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::FindConditionNonLeaf(
       bool(*condition)(const key_type&, const K&), const K& key){
 
     node_ptr candidate_node = this;
-    child_map* children = &(this->GetChildren());
+    const child_map* children = &(this->GetChildren());
     bool match_found = false;
 
+    // Non-leaf nodes do not store their key, so it is rebuilt during the descent
+    key_type prefix; // Key of the node whose children are searched
+    key_type buffer;
+    auto child_key = [&prefix, &buffer](const_node_ptr child) -> const key_type& {
+      if (child->IsLeaf()){
+        return child->GetKey();
+      }
+      buffer.assign(prefix).append(child->GetLabel());
+      return buffer;
+    };
+
     while(!match_found){
 
       // Search for first child that matches the condition in search node
-      auto it = children->cbegin();
-      auto endit = children->cend();
-      while (it != endit && !condition(it->second->GetKey(), key)){
-        ++it;
+      size_t pos = 0;
+      size_t endpos = children->size();
+      while (pos != endpos && !condition(child_key(children->ChildAt(pos)), key)){
+        ++pos;
       }
-      // Search done. Iterator may now point to map element or to end iterator
+      // Search done. Position may now point to a child or to the end
 
-      if (it != endit) {
-        candidate_node = it->second;
+      if (pos != endpos) {
+        candidate_node = children->ChildAt(pos);
       }
       
       // If match is the first in among the children, then there cannot be a match
       // preceding the candidate
-      if (it == children->begin()){
+      if (pos == 0){
         match_found = true;
       }
       else {
-        --it;
-        children = &(it->second->GetChildren());
+        prefix.append(children->ChildAt(pos-1)->GetLabel());
+        children = &(children->ChildAt(pos-1)->GetChildren());
       }
       
     } // while
     return candidate_node;
   }
 
-  template <class T, class Compare>
-  bool Node<T,Compare>::IsChildless() const {
+  // Byte-wise counterpart of FindConditionNonLeaf() for lexicographic comparators. Finds the
+  // first node whose key is not smaller than the key, or with Upper, greater than the key. At
+  // each level, only the child that starts with the next byte of the key is compared, and its
+  // next sibling is remembered in case no node in its subtree is large enough.
+  // The key is relative to this node, which need not be the root. The candidate is the first node
+  // after the subtree of this node, which is returned if no node in the subtree is large enough.
+  template <class T, class Compare, class Allocator, class Options> template <bool Upper>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::FindBoundNonLeaf(std::string_view key, node_ptr candidate_node){
+    node_ptr node = this;
+
+    while (true){
+      const child_map& children = node->GetChildren();
+
+      // The key of node equals the key, so only its descendants are greater
+      if (key.empty()){
+        if (!Upper && node->GetParent()){
+          return node;
+        }
+        return children.empty()? candidate_node : children.Front();
+      }
+
+      size_t pos = children.LowerPosition(key.front());
+      if (pos == children.size()){
+        return candidate_node;
+      }
+      node_ptr child = children.ChildAt(pos);
+      if (children.ByteAt(pos) != static_cast<unsigned char>(key.front())){
+        return child;
+      }
+
+      std::string_view label = child->GetLabel();
+      size_t common_length = CommonPrefix(label, key);
+      auto label_it = label.begin() + common_length;
+      auto key_it = key.begin() + common_length;
+      if (label_it == label.end()){
+        // Edge label is a prefix of the remaining key, the match is in the subtree of child or
+        // it is the next sibling
+        if (pos + 1 < children.size()){
+          candidate_node = children.ChildAt(pos + 1);
+        }
+        key.remove_prefix(label.size());
+        node = child;
+      }
+      else if (key_it == key.end() || static_cast<unsigned char>(*label_it) > static_cast<unsigned char>(*key_it)){
+        return child;
+      }
+      else {
+        return (pos + 1 < children.size())? children.ChildAt(pos + 1) : candidate_node;
+      }
+    }
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  bool Node<T,Compare,Allocator,Options>::IsChildless() const {
     return !GetChildren().size();
   }
 
-  template <class T, class Compare>
-  bool Node<T,Compare>::IsLeaf() const {
-    return m_is_leaf;
+  template <class T, class Compare, class Allocator, class Options>
+  bool Node<T,Compare,Allocator,Options>::IsLeaf() const {
+    return link::Tag(m_parent);
   }
   
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::GetParent() const {
-    return m_parent;
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GetParent() const {
+    return link::Load(m_parent);
   }
   
-  template <class T, class Compare>
-  void Node<T,Compare>::SetParent(node_ptr node){
-    m_parent = node;
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::SetParent(node_ptr node){
+    link::Store(m_parent, node, IsLeaf());
   }
   
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::GetFirstChild() const {
-    return GetChildren().begin()->second;
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GetFirstChild() const {
+    return GetChildren().Front();
+  }
+
+  // First leaf in the subtree of a node. The root stands for the end of the radix and is
+  // returned as it is.
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GetFirstLeaf() {
+    node_ptr candidate = this;
+    if (candidate->GetParent()){
+      while (!candidate->IsLeaf()){
+        candidate = candidate->GetFirstChild();
+      }
+    }
+    return candidate;
   }
 
-  template <class T, class Compare>
-  typename Node<T,Compare>::node_ptr Node<T,Compare>::GetLastDescendant() {
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GetLastDescendant() {
     node_ptr candidate = this;
     while (!candidate->GetChildren().empty()){
-      candidate = candidate->GetChildren().rbegin()->second;
+      candidate = candidate->GetChildren().Back();
     }
     return candidate;
   }
   
-  template <class T, class Compare>
-  typename Node<T,Compare>::child_map& Node<T,Compare>::GetChildren(){
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::child_map& Node<T,Compare,Allocator,Options>::GetChildren(){
     return m_children;
   }
 
-  template <class T, class Compare>
-  const typename Node<T,Compare>::child_map& Node<T,Compare>::GetChildren() const {
+  template <class T, class Compare, class Allocator, class Options>
+  const typename Node<T,Compare,Allocator,Options>::child_map& Node<T,Compare,Allocator,Options>::GetChildren() const {
     return m_children;
   }
 
-  template <class T, class Compare>
-  const typename Node<T,Compare>::key_type& Node<T,Compare>::GetKey() const {
-    return m_value_pair.first;
+  template <class T, class Compare, class Allocator, class Options>
+  const typename Node<T,Compare,Allocator,Options>::key_type& Node<T,Compare,Allocator,Options>::GetKey() const {
+    return Value_traits<key_type,T>::GetKey(GetValuePair());
+  }
+
+  // Only leaf nodes hold a value pair
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::value_type& Node<T,Compare,Allocator,Options>::GetValuePair(){
+    assert(IsLeaf());
+    return static_cast<Leaf_node<T,Compare,Allocator,Options>*>(this)->m_value_pair;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  const typename Node<T,Compare,Allocator,Options>::value_type& Node<T,Compare,Allocator,Options>::GetValuePair() const {
+    assert(IsLeaf());
+    return static_cast<const Leaf_node<T,Compare,Allocator,Options>*>(this)->m_value_pair;
+  }
+
+  // Label of the edge that connects this node to its parent
+  template <class T, class Compare, class Allocator, class Options>
+  std::string_view Node<T,Compare,Allocator,Options>::GetLabel() const {
+    return m_label.View();
+  }
+
+  // The label of a leaf node must be a suffix of its key, long labels refer to the key
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::SetLabel(std::string_view label, const allocator_type& alloc){
+    if (IsLeaf()){
+      assert(GetKey().ends_with(label));
+      m_label.Borrow(std::string_view(GetKey()).substr(GetKey().size() - label.size()), alloc);
+    }
+    else {
+      m_label.Assign(label, alloc);
+    }
+  }
+
+  // First byte of the edge label that connects this node to its parent
+  template <class T, class Compare, class Allocator, class Options>
+  unsigned char Node<T,Compare,Allocator,Options>::GetEdgeByte() const {
+    return GetLabel().front();
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GetPrevLeaf() const {
+    return link::Load(static_cast<const Leaf_node<T,Compare,Allocator,Options>*>(this)->m_links.prev);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node<T,Compare,Allocator,Options>::node_ptr Node<T,Compare,Allocator,Options>::GetNextLeaf() const {
+    return link::Load(static_cast<const Leaf_node<T,Compare,Allocator,Options>*>(this)->m_links.next);
+  }
+
+  // Inserts this leaf into the list of leaves between two neighbours, either of which may be null
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::LinkLeaf(node_ptr prev, node_ptr next){
+    LinkLeaves(this, prev, next);
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::UnlinkLeaf(){
+    UnlinkLeaves(this);
+  }
+
+  // Inserts the leaves from this one to the last, which are already linked to each other, into
+  // the list of leaves between two neighbours
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::LinkLeaves(node_ptr last, node_ptr prev, node_ptr next){
+    link::Store(static_cast<Leaf_node<T,Compare,Allocator,Options>*>(this)->m_links.prev, prev);
+    link::Store(static_cast<Leaf_node<T,Compare,Allocator,Options>*>(last)->m_links.next, next);
+    if (prev){
+      link::Store(static_cast<Leaf_node<T,Compare,Allocator,Options>*>(prev)->m_links.next, this);
+    }
+    if (next){
+      link::Store(static_cast<Leaf_node<T,Compare,Allocator,Options>*>(next)->m_links.prev, last);
+    }
+  }
+
+  // Removes the leaves from this one to the last from the list of leaves, the links between them
+  // remain
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::UnlinkLeaves(node_ptr last){
+    auto& first_links = static_cast<Leaf_node<T,Compare,Allocator,Options>*>(this)->m_links;
+    auto& last_links = static_cast<Leaf_node<T,Compare,Allocator,Options>*>(last)->m_links;
+    node_ptr prev = link::Load(first_links.prev);
+    node_ptr next = link::Load(last_links.next);
+    if (prev){
+      link::Store(static_cast<Leaf_node<T,Compare,Allocator,Options>*>(prev)->m_links.next, next);
+    }
+    if (next){
+      link::Store(static_cast<Leaf_node<T,Compare,Allocator,Options>*>(next)->m_links.prev, prev);
+    }
+    link::Store(first_links.prev, nullptr);
+    link::Store(last_links.next, nullptr);
   }
   
-  template <class T, class Compare>
-  void Node<T,Compare>::print() const {
+  template <class T, class Compare, class Allocator, class Options>
+  void Node<T,Compare,Allocator,Options>::print() const {
     std::cout << " ("<< (IsLeaf()? "+" : "-") << ")";
     std::cout << " <";
-    for (auto& entry : GetChildren()){
-      std::cout << entry.first;
-      entry.second->print();
+    for (const_node_ptr child : GetChildren()){
+      std::cout << child->GetLabel();
+      child->print();
     }
     std::cout << "> ";
   }
 
   /////////////////
-  // NODE HANDLE //
+  // BULK LOADER //
   /////////////////
-  template <class T, class Compare>
-  Node_handle<T,Compare>::~Node_handle(){
-    // If node is orphan and has no children, then delete
-    // Otherwise, node will be deleted by its parent
-    if (m_node_ptr && !m_node_ptr->GetParent() && !m_node_ptr->CountChildren()){
-      delete m_node_ptr;
+  template <class T, class Compare, class Allocator, class Options>
+  Bulk_loader<T,Compare,Allocator,Options>::Bulk_loader(node_ptr node, std::string_view key, const Allocator& alloc)
+    : m_path{{node, key.size()}},
+      m_last_key(key),
+      m_alloc(alloc) {}
+
+  template <class T, class Compare, class Allocator, class Options>
+  Bulk_loader<T,Compare,Allocator,Options>::~Bulk_loader(){
+    while (m_path.size() > 1){
+      Node<T,Compare,Allocator,Options>::Delete(m_path.back().node, m_alloc);
+      m_path.pop_back();
+    }
+  }
+
+  // Key of the last leaf, or of the node before the first leaf
+  template <class T, class Compare, class Allocator, class Options>
+  std::string_view Bulk_loader<T,Compare,Allocator,Options>::LastKey() const noexcept {
+    return m_last_key;
+  }
+
+  // Takes over the leaf if its key follows the last key in ascending order and returns true.
+  // Otherwise, the leaf is left to the caller.
+  template <class T, class Compare, class Allocator, class Options>
+  bool Bulk_loader<T,Compare,Allocator,Options>::Append(node_ptr leaf){
+    std::string_view key = leaf->GetKey();
+    size_t common_length = CommonPrefix(m_last_key, key);
+    if (common_length == key.size() || (common_length < m_last_key.size() &&
+        static_cast<unsigned char>(key[common_length]) < static_cast<unsigned char>(m_last_key[common_length]))){
+      return false;
+    }
+
+    // The subtrees below the common prefix are complete
+    while (m_path.back().depth > common_length){
+      LinkLast(common_length);
+    }
+    m_path.push_back({leaf, key.size()});
+    m_last_key = key;
+    return true;
+  }
+
+  // Links all nodes that wait on the path
+  template <class T, class Compare, class Allocator, class Options>
+  void Bulk_loader<T,Compare,Allocator,Options>::Finish(){
+    while (m_path.size() > 1){
+      LinkLast(m_path.front().depth);
+    }
+  }
+
+  // Links the last node on the path to the node before it, or to a new node of the given depth
+  // if the node before it is shallower. The new node then takes its place on the path.
+  template <class T, class Compare, class Allocator, class Options>
+  void Bulk_loader<T,Compare,Allocator,Options>::LinkLast(size_t depth){
+    Pending child = m_path.back();
+    Pending& parent = m_path[m_path.size() - 2];
+    if (parent.depth >= depth){
+      parent.node->AppendChild(m_last_key.substr(parent.depth, child.depth - parent.depth), child.node, m_alloc);
+      m_path.pop_back();
     }
     else {
-      m_node_ptr = nullptr;
+      node_ptr inner = Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+      try {
+        inner->AppendChild(m_last_key.substr(depth, child.depth - depth), child.node, m_alloc);
+      }
+      catch (...) {
+        Node<T,Compare,Allocator,Options>::Delete(inner, m_alloc);
+        throw;
+      }
+      m_path.back() = {inner, depth};
+    }
+  }
+
+  /////////////////////
+  // PARALLEL LOADER //
+  /////////////////////
+  template <class T, class Compare, class Allocator, class Options>
+  Parallel_loader<T,Compare,Allocator,Options>::Parallel_loader(const Allocator& alloc, unsigned threads)
+    : m_alloc(alloc),
+      m_threads(std::max(threads, 1u)),
+      m_grain(0),
+      m_root(nullptr),
+      m_count(0) {}
+
+  template <class T, class Compare, class Allocator, class Options>
+  Parallel_loader<T,Compare,Allocator,Options>::~Parallel_loader(){
+    for (const Task& task : m_tasks){
+      if (task.subtree){
+        Node<T,Compare,Allocator,Options>::Delete(task.subtree, m_alloc);
+      }
+    }
+    for (node_ptr leaf : m_leaves){
+      if (leaf){
+        Node<T,Compare,Allocator,Options>::Delete(leaf, m_alloc);
+      }
+    }
+  }
+
+  // Builds the tree of the elements below the root, which must have no children. Returns the
+  // number of elements in the tree.
+  template <class T, class Compare, class Allocator, class Options> template <class It>
+  size_t Parallel_loader<T,Compare,Allocator,Options>::Load(It first, It last, node_ptr root){
+    const size_t size = static_cast<size_t>(last - first);
+    m_root = root;
+    m_leaves.assign(size, nullptr);
+    m_buffer.resize(size);
+    // A few tasks per thread balance subtrees of different size
+    m_grain = std::max<size_t>(size / (size_t(m_threads) * 8), 1024);
+
+    const size_t chunks = std::min<size_t>(size_t(m_threads) * 4, (size + 4095) / 4096);
+    ParallelFor(chunks, m_threads, [&](size_t chunk){
+      for (size_t i = size * chunk / chunks; i < size * (chunk + 1) / chunks; ++i){
+        m_leaves[i] = Node<T,Compare,Allocator,Options>::NewLeaf(m_alloc, first[i]);
+      }
+    });
+
+    Partition(0, size, 0, nullptr, 0);
+
+    // Larger subtrees first, so that the threads finish at about the same time
+    std::vector<size_t> order(m_tasks.size());
+    for (size_t i = 0; i < order.size(); ++i){
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs){
+      return m_tasks[lhs].end - m_tasks[lhs].begin > m_tasks[rhs].end - m_tasks[rhs].begin;
+    });
+    ParallelFor(order.size(), m_threads, [&](size_t i){
+      Build(m_tasks[order[i]]);
+    });
+
+    // The only child of a stand-in moves to the parent
+    for (Task& task : m_tasks){
+      node_ptr child = task.subtree->GetChildren().Front();
+      auto& siblings = task.parent->GetChildren();
+      siblings.Insert(siblings.LowerPosition(child->GetEdgeByte()), child->GetEdgeByte(), child, m_alloc);
+      task.subtree->GetChildren().Erase(0, m_alloc);
+      child->SetParent(task.parent);
+      Node<T,Compare,Allocator,Options>::Delete(task.subtree, m_alloc);
+      task.subtree = nullptr;
+      m_count += task.count;
+    }
+    return m_count;
+  }
+
+  // Partitions the leaves in [begin, end), whose keys share their first depth bytes, by the next
+  // byte. The node with the shared key is created and linked to the parent, which has a key of
+  // the parent depth. It is the first leaf with that key if there is one, and the root if there
+  // is no parent.
+  template <class T, class Compare, class Allocator, class Options>
+  void Parallel_loader<T,Compare,Allocator,Options>::Partition(size_t begin, size_t end, size_t depth, node_ptr parent, size_t parent_depth){
+    // Bucket 256 holds the keys that end at the depth
+    constexpr size_t buckets = 257;
+    struct Histogram{
+      size_t count[buckets] = {};
+      size_t next[buckets];
+      std::string_view first[buckets];   // First key in the bucket
+      size_t common[buckets];             // Length of the common prefix of its keys
+    };
+
+    const size_t size = end - begin;
+    const size_t chunks = std::min<size_t>(size_t(m_threads) * 4, (size + 4095) / 4096);
+    auto chunk_begin = [&](size_t chunk){ return begin + size * chunk / chunks; };
+    auto bucket_of = [depth](std::string_view key){
+      return key.size() == depth? buckets - 1 : static_cast<unsigned char>(key[depth]);
+    };
+
+    std::vector<Histogram> histograms(chunks);
+    ParallelFor(chunks, m_threads, [&](size_t chunk){
+      Histogram& histogram = histograms[chunk];
+      for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i){
+        std::string_view key = m_leaves[i]->GetKey();
+        size_t bucket = bucket_of(key);
+        if (histogram.count[bucket]++ == 0){
+          histogram.first[bucket] = key;
+          histogram.common[bucket] = key.size();
+        }
+        else {
+          size_t& common = histogram.common[bucket];
+          common = depth + CommonPrefix(histogram.first[bucket].substr(depth, common - depth), key.substr(depth));
+        }
+      }
+    });
+
+    // Buckets are laid out in byte order, each chunk writes behind the previous chunks
+    Histogram total;
+    size_t offset = begin;
+    for (size_t bucket = 0; bucket < buckets; ++bucket){
+      for (Histogram& histogram : histograms){
+        if (!histogram.count[bucket]){
+          continue;
+        }
+        if (!total.count[bucket]){
+          total.first[bucket] = histogram.first[bucket];
+          total.common[bucket] = histogram.common[bucket];
+        }
+        else {
+          size_t& common = total.common[bucket];
+          common = std::min(common, histogram.common[bucket]);
+          common = depth + CommonPrefix(total.first[bucket].substr(depth, common - depth), histogram.first[bucket].substr(depth));
+        }
+        total.count[bucket] += histogram.count[bucket];
+        histogram.next[bucket] = offset;
+        offset += histogram.count[bucket];
+      }
+      total.next[bucket] = offset - total.count[bucket];
+    }
+
+    ParallelFor(chunks, m_threads, [&](size_t chunk){
+      Histogram& histogram = histograms[chunk];
+      for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1); ++i){
+        m_buffer[histogram.next[bucket_of(m_leaves[i]->GetKey())]++] = m_leaves[i];
+      }
+    });
+    ParallelFor(chunks, m_threads, [&](size_t chunk){
+      std::copy(m_buffer.begin() + chunk_begin(chunk), m_buffer.begin() + chunk_begin(chunk + 1), m_leaves.begin() + chunk_begin(chunk));
+    });
+
+    // Keys that end here are dropped at the root, otherwise the first one becomes the node
+    node_ptr node = parent? nullptr : m_root;
+    const size_t ends = total.next[buckets - 1];
+    for (size_t i = ends; i < ends + total.count[buckets - 1]; ++i){
+      if (!node){
+        node = m_leaves[i];
+        ++m_count;
+      }
+      else {
+        Node<T,Compare,Allocator,Options>::Delete(m_leaves[i], m_alloc);
+      }
+      m_leaves[i] = nullptr;
+    }
+    if (parent){
+      // Without a leaf, the key is taken from the first leaf, which is below the node
+      std::string_view key = node? std::string_view(node->GetKey()) : std::string_view(m_leaves[begin]->GetKey());
+      if (!node){
+        node = Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+      }
+      try {
+        parent->AppendChild(key.substr(parent_depth, depth - parent_depth), node, m_alloc);
+      }
+      catch (...) {
+        Node<T,Compare,Allocator,Options>::Delete(node, m_alloc);
+        throw;
+      }
+    }
+
+    for (size_t bucket = 0; bucket < buckets - 1; ++bucket){
+      const size_t first = total.next[bucket];
+      const size_t count = total.count[bucket];
+      if (count > m_grain){
+        Partition(first, first + count, total.common[bucket], node, depth);
+      }
+      else if (count){
+        m_tasks.push_back({first, first + count, depth, node, nullptr, 0});
+      }
+    }
+  }
+
+  // Sorts the leaves of the task and builds their subtree below a stand-in for the parent.
+  // Equal keys keep the order of the elements, so the first one is kept.
+  template <class T, class Compare, class Allocator, class Options>
+  void Parallel_loader<T,Compare,Allocator,Options>::Build(Task& task){
+    // The next 8 bytes of a key, most significant first, decide most comparisons without
+    // touching the leaf
+    struct Entry{
+      uint64_t head;
+      std::string_view key;
+      size_t position;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(task.end - task.begin);
+    for (size_t i = task.begin; i < task.end; ++i){
+      std::string_view key = m_leaves[i]->GetKey();
+      uint64_t head = 0;
+      for (size_t j = task.depth; j < task.depth + 8; ++j){
+        head = (head << 8) | (j < key.size()? static_cast<unsigned char>(key[j]) : 0);
+      }
+      entries.push_back({head, key, i});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs){
+      if (lhs.head != rhs.head){
+        return lhs.head < rhs.head;
+      }
+      int order = lhs.key.compare(rhs.key);
+      return order < 0 || (order == 0 && lhs.position < rhs.position);
+    });
+
+    task.subtree = Node<T,Compare,Allocator,Options>::NewInner(m_alloc);
+    Bulk_loader<T,Compare,Allocator,Options> loader(task.subtree, entries.front().key.substr(0, task.depth), m_alloc);
+    for (const Entry& entry : entries){
+      if (entry.key == loader.LastKey()){
+        Node<T,Compare,Allocator,Options>::Delete(m_leaves[entry.position], m_alloc);
+      }
+      else {
+        loader.Append(m_leaves[entry.position]);
+        ++task.count;
+      }
+      m_leaves[entry.position] = nullptr;
     }
+    loader.Finish();
+  }
+
+  /////////////////
+  // NODE HANDLE //
+  /////////////////
+  template <class T, class Compare, class Allocator, class Options>
+  Node_handle<T,Compare,Allocator,Options>::~Node_handle(){
+    Reset();
   }
 
-  template <class T, class Compare>
-  Node_handle<T,Compare>::Node_handle(Node_handle<T,Compare>&& node) noexcept {
-    m_node_ptr = node.m_node_ptr;
+  template <class T, class Compare, class Allocator, class Options>
+  Node_handle<T,Compare,Allocator,Options>::Node_handle(Node_handle<T,Compare,Allocator,Options>&& node) noexcept
+    : m_node_ptr(node.m_node_ptr), m_alloc(std::move(node.m_alloc)) {
     node.m_node_ptr = nullptr;
+    node.m_alloc.reset();
   }
   
-  template <class T, class Compare>
-  Node_handle<T,Compare>& Node_handle<T,Compare>::operator=(Node_handle<T,Compare>&& node){
-    if (m_node_ptr && !m_node_ptr->GetParent() && !m_node_ptr->CountChildren()){
-      delete m_node_ptr;
+  template <class T, class Compare, class Allocator, class Options>
+  Node_handle<T,Compare,Allocator,Options>& Node_handle<T,Compare,Allocator,Options>::operator=(Node_handle<T,Compare,Allocator,Options>&& node){
+    if (this != &node){
+      Reset();
+      m_node_ptr = node.m_node_ptr;
+      SetAllocator(node.m_alloc);
+      node.m_node_ptr = nullptr;
+      node.m_alloc.reset();
     }
-    m_node_ptr = node.m_node_ptr;
-    node.m_node_ptr = nullptr;
     return *this;    
   }
 
-  template <class T, class Compare>
-  Node_handle<T,Compare>::Node_handle(node_ptr node) : m_node_ptr(node) {}
+  template <class T, class Compare, class Allocator, class Options>
+  Node_handle<T,Compare,Allocator,Options>::Node_handle(node_ptr node, const allocator_type& alloc) 
+    : m_node_ptr(node), m_alloc(alloc) {}
+
+  // If node is orphan and has no children, then delete
+  // Otherwise, node will be deleted by its parent
+  template <class T, class Compare, class Allocator, class Options>
+  void Node_handle<T,Compare,Allocator,Options>::Reset() noexcept {
+    if (m_node_ptr && !m_node_ptr->GetParent() && !m_node_ptr->CountChildren()){
+      Node<T,Compare,Allocator,Options>::Delete(m_node_ptr, *m_alloc);
+    }
+    m_node_ptr = nullptr;
+    m_alloc.reset();
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node_handle<T,Compare,Allocator,Options>::allocator_type Node_handle<T,Compare,Allocator,Options>::get_allocator() const {
+    return *m_alloc;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  void Node_handle<T,Compare,Allocator,Options>::swap(Node_handle& other) noexcept(
+      std::allocator_traits<allocator_type>::propagate_on_container_swap::value ||
+      std::allocator_traits<allocator_type>::is_always_equal::value){
+    std::swap(m_node_ptr, other.m_node_ptr);
+    std::optional<allocator_type> alloc;
+    if (m_alloc){
+      alloc.emplace(*m_alloc);
+    }
+    SetAllocator(other.m_alloc);
+    other.SetAllocator(alloc);
+  }
+
+  // Allocators need not be assignable (e.g. std::pmr::polymorphic_allocator), so they are
+  // copy constructed in place
+  template <class T, class Compare, class Allocator, class Options>
+  void Node_handle<T,Compare,Allocator,Options>::SetAllocator(const std::optional<allocator_type>& alloc){
+    m_alloc.reset();
+    if (alloc){
+      m_alloc.emplace(*alloc);
+    }
+  }
 
-  template <class T, class Compare>
-  [[nodiscard]] bool Node_handle<T,Compare>::empty() const noexcept {
+  template <class T, class Compare, class Allocator, class Options>
+  [[nodiscard]] bool Node_handle<T,Compare,Allocator,Options>::empty() const noexcept {
     return !m_node_ptr;
   }
       
-  template <class T, class Compare>
-  Node_handle<T,Compare>::operator bool() const noexcept {
+  template <class T, class Compare, class Allocator, class Options>
+  Node_handle<T,Compare,Allocator,Options>::operator bool() const noexcept {
     return m_node_ptr;
   }
   
-  template <class T, class Compare>
-  const typename Node_handle<T,Compare>::key_type& Node_handle<T,Compare>::key() const {
+  template <class T, class Compare, class Allocator, class Options>
+  const typename Node_handle<T,Compare,Allocator,Options>::key_type& Node_handle<T,Compare,Allocator,Options>::key() const {
     return m_node_ptr->GetKey();
   }
                                                                                
-  template <class T, class Compare>
-  typename Node_handle<T,Compare>::mapped_type& Node_handle<T,Compare>::mapped() const {
-    return m_node_ptr->m_value_pair.second;
+  template <class T, class Compare, class Allocator, class Options>
+  typename Node_handle<T,Compare,Allocator,Options>::mapped_type& Node_handle<T,Compare,Allocator,Options>::mapped() const {
+    return m_node_ptr->GetValuePair().second;
+  }
+
+  template <class T, class Compare, class Allocator, class Options>
+  const typename Node_handle<T,Compare,Allocator,Options>::value_type& Node_handle<T,Compare,Allocator,Options>::value() const {
+    return m_node_ptr->GetValuePair();
   }
 
 }
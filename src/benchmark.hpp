@@ -17,6 +17,18 @@ namespace benchmark{
       << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() 
       << " us" << std::endl;
   }
+
+  // Like time(), and reports how many of the items func processes per microsecond
+  void throughput(std::function<void()> func, std::string bm_name, size_t items){
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    func();
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    std::cout << "Benchmark - " << bm_name << ": " << us << " us, "
+      << static_cast<double>(items) / static_cast<double>(us? us : 1) << " per us" << std::endl;
+  }
 }
 
 #endif
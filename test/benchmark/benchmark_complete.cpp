@@ -45,5 +45,37 @@ int main() {
   };
 
   benchmark::time(complete_many_const, "Complete const");
+
+  // Benchmark for enumerating the completions, with and without links between the leaves
+  typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+  xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::leaf_linked>> l_rdx;
+  l_rdx.insert(c_rdx.begin(), c_rdx.end());
+  volatile size_t sink = 0;
+
+  std::function<void()> scan_many = [secondhalf, &c_rdx, &sink]() {
+    size_t n = 0;
+    for (auto word : secondhalf) {
+      auto [b_it, e_it] = c_rdx.complete(word.substr(0, 1));
+      for (; b_it != e_it; ++b_it){
+        n += b_it->second;
+      }
+    }
+    sink = n;
+  };
+
+  benchmark::time(scan_many, "Complete and scan");
+
+  std::function<void()> scan_many_linked = [secondhalf, &l_rdx, &sink]() {
+    size_t n = 0;
+    for (auto word : secondhalf) {
+      auto [b_it, e_it] = l_rdx.complete(word.substr(0, 1));
+      for (; b_it != e_it; ++b_it){
+        n += b_it->second;
+      }
+    }
+    sink = n;
+  };
+
+  benchmark::time(scan_many_linked, "Complete and scan leaf linked");
 }
 
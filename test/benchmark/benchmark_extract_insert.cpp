@@ -38,6 +38,103 @@ int main(){
   };
 
   benchmark::time(extract_then_insert, "radix extract the insert");
-    
+
+  std::function<void()> merge = [rdx, rdx_2nd]() mutable {
+    rdx_2nd.merge(rdx);
+  };
+
+  benchmark::time(merge, "radix merge");
+
+  // Shards of an index built on separate threads share the upper levels of the tree, but
+  // not their elements
+  const size_t shard_count = 4;
+  std::vector<radix> shards(shard_count);
+  for (size_t i = 0; i < 1000000; ++i){
+    shards[i % shard_count].emplace(common_words[i % common_words.size()] + "/"
+                                    + common_words[(i * 7919) % common_words.size()] + "/" + std::to_string(i), 1);
+  }
+
+  std::function<void()> extract_then_insert_shards = [shards]() mutable {
+    for (size_t shard = 1; shard < shard_count; ++shard){
+      while (!shards[shard].empty()){
+        shards[0].insert(shards[shard].extract(shards[shard].begin()));
+      }
+    }
+  };
+
+  std::function<void()> merge_shards = [shards]() mutable {
+    for (size_t shard = 1; shard < shard_count; ++shard){
+      shards[0].merge(shards[shard]);
+    }
+  };
+
+  benchmark::time(extract_then_insert_shards, "radix extract then insert 4 shards of 250000 paths");
+  benchmark::time(merge_shards, "radix merge 4 shards of 250000 paths");
+
+  // Shards that hold separate key ranges only share the root
+  std::vector<radix> ranges(shard_count);
+  for (size_t i = 0; i < 1000000; ++i){
+    const std::string& word = common_words[i % common_words.size()];
+    ranges[static_cast<unsigned char>(word.front()) % shard_count].emplace(
+        word + "/" + common_words[(i * 7919) % common_words.size()] + "/" + std::to_string(i), 1);
+  }
+
+  std::function<void()> merge_ranges = [ranges]() mutable {
+    for (size_t shard = 1; shard < shard_count; ++shard){
+      ranges[0].merge(ranges[shard]);
+    }
+  };
+
+  benchmark::time(merge_ranges, "radix merge 4 key ranges of 1000000 paths");
+
+  // Carving out the paths below a prefix, and the keys from the middle on, into a new radix
+  radix paths;
+  for (size_t i = 0; i < 1000000; ++i){
+    paths.emplace(common_words[i % common_words.size()] + "/"
+                  + common_words[(i * 7919) % common_words.size()] + "/" + std::to_string(i), 1);
+  }
+
+  // The carved trees outlive the measurements, which would otherwise include their destruction
+  std::vector<radix> carved(3);
+
+  std::function<void()> extract_then_insert_prefix = [paths, &carved]() mutable {
+    auto [first, last] = paths.complete("s");
+    while (first != last){
+      carved[0].insert(paths.extract(first++));
+    }
+  };
+
+  std::function<void()> extract_prefix = [paths, &carved]() mutable {
+    carved[1] = paths.extract_prefix("s");
+  };
+
+  std::function<void()> split = [paths, &carved]() mutable {
+    carved[2] = paths.split("m");
+  };
+
+  benchmark::time(extract_then_insert_prefix, "radix extract then insert the paths below a prefix");
+  benchmark::time(extract_prefix, "radix extract_prefix of the paths below a prefix");
+  benchmark::time(split, "radix split 1000000 paths at a key");
+
+  // Dropping the paths below a prefix
+  std::function<void()> erase_one_by_one = [paths]() mutable {
+    auto [first, last] = paths.complete("s");
+    while (first != last){
+      first = paths.erase(first);
+    }
+  };
+
+  std::function<void()> erase_range = [paths]() mutable {
+    auto [first, last] = paths.complete("s");
+    paths.erase(first, last);
+  };
+
+  std::function<void()> erase_prefix = [paths]() mutable {
+    paths.erase_prefix("s");
+  };
+
+  benchmark::time(erase_one_by_one, "radix erase the paths below a prefix one by one");
+  benchmark::time(erase_range, "radix erase the range of the paths below a prefix");
+  benchmark::time(erase_prefix, "radix erase_prefix of the paths below a prefix");
 }
 
@@ -0,0 +1,83 @@
+#include <vector>
+#include <string>
+#include <memory>
+#include <random>
+#include <algorithm>
+#include "radix.hpp"
+#include "commonwords.hpp"
+#include "benchmark.hpp"
+
+// Compares the throughput of find_many and contains_many with a loop of find and contains, for
+// the same keys in random order. Half of the probes miss by their last byte.
+template <class Radix>
+void timeBatch(const std::vector<std::string>& keys, const std::string& name){
+  Radix rdx;
+  for (const std::string& key : keys){
+    rdx.emplace(key, 1);
+  }
+
+  const size_t lookups = 1000000;
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+  std::vector<std::string> probes;
+  for (size_t i = 0; i < lookups; ++i){
+    probes.push_back(keys[pick(gen)]);
+    if (i % 2){
+      probes.back().back() = '#';
+    }
+  }
+
+  std::vector<typename Radix::const_iterator> found(lookups);
+  std::unique_ptr<bool[]> contained(new bool[lookups]);
+  volatile size_t sink = 0;
+
+  std::function<void()> find_loop = [&]() {
+    for (size_t i = 0; i < lookups; ++i){
+      found[i] = std::as_const(rdx).find(probes[i]);
+    }
+    sink = std::count(found.begin(), found.end(), rdx.cend());
+  };
+
+  std::function<void()> find_many = [&]() {
+    std::as_const(rdx).find_many(probes, std::span(found));
+    sink = std::count(found.begin(), found.end(), rdx.cend());
+  };
+
+  std::function<void()> contains_loop = [&]() {
+    for (size_t i = 0; i < lookups; ++i){
+      contained[i] = rdx.contains(probes[i]);
+    }
+    sink = std::count(contained.get(), contained.get() + lookups, true);
+  };
+
+  std::function<void()> contains_many = [&]() {
+    rdx.contains_many(probes, std::span(contained.get(), lookups));
+    sink = std::count(contained.get(), contained.get() + lookups, true);
+  };
+
+  benchmark::throughput(find_loop, name + " find loop", lookups);
+  benchmark::throughput(find_many, name + " find_many", lookups);
+  benchmark::throughput(contains_loop, name + " contains loop", lookups);
+  benchmark::throughput(contains_many, name + " contains_many", lookups);
+}
+
+int main() {
+
+  // Import 10000 words
+  auto [common_words, import_success] = commonwords::readWords();
+  if (!import_success){
+    commonwords::failedImport();
+  }
+  timeBatch<xsm::radix<int>>(common_words, "10000 words");
+
+  // Enough keys that the nodes do not fit into the caches
+  std::vector<std::string> paths;
+  for (size_t i = 0; i < 1000000; ++i){
+    paths.push_back(common_words[i % common_words.size()] + "/" + common_words[(i * 7919) % common_words.size()]
+                    + "/" + std::to_string(i));
+  }
+  timeBatch<xsm::radix<int>>(paths, "1000000 paths");
+
+  typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+  timeBatch<xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::root_indexed<>>>>(paths, "1000000 paths, root index");
+}
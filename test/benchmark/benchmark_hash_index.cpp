@@ -0,0 +1,82 @@
+#include <vector>
+#include <string>
+#include "radix.hpp"
+#include "commonwords.hpp"
+#include "benchmark.hpp"
+
+typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::hash_indexed<>>> hashed_radix;
+
+// Times the same number of lookups in radix instances of increasing size, with and without a
+// hash index, to show from which size on the hash index pays off. The keys are also looked up
+// with a changed last byte, which misses.
+template <class Radix>
+void timeFind(const std::vector<std::string>& words, size_t n, const std::string& name){
+  Radix rdx;
+  std::vector<std::string> keys(words.begin(), words.begin() + n);
+  std::vector<std::string> misses;
+  for (const std::string& key : keys){
+    rdx.emplace(key, 1);
+    misses.push_back(key);
+    misses.back().back() = '#';
+  }
+
+  const size_t lookups = 200000;
+  volatile size_t sink = 0;
+
+  std::function<void()> find_hits = [&keys, &rdx, &sink, lookups]() {
+    size_t found = 0;
+    for (size_t i = 0; i < lookups; ++i){
+      found += rdx.contains(keys[i % keys.size()]);
+    }
+    sink = found;
+  };
+
+  std::function<void()> find_misses = [&misses, &rdx, &sink, lookups]() {
+    size_t found = 0;
+    for (size_t i = 0; i < lookups; ++i){
+      found += rdx.contains(misses[i % misses.size()]);
+    }
+    sink = found;
+  };
+
+  benchmark::time(find_hits, name + " hits, n = " + std::to_string(n));
+  benchmark::time(find_misses, name + " misses, n = " + std::to_string(n));
+}
+
+int main() {
+
+  // Import 10000 words
+  auto [common_words, import_success] = commonwords::readWords();
+  if (!import_success){
+    commonwords::failedImport();
+  }
+
+  for (size_t n : {16, 256, 4096}){
+    if (n > common_words.size()){
+      break;
+    }
+    timeFind<xsm::radix<int>>(common_words, n, "tree contains");
+    timeFind<hashed_radix>(common_words, n, "hash index contains");
+  }
+  timeFind<xsm::radix<int>>(common_words, common_words.size(), "tree contains");
+  timeFind<hashed_radix>(common_words, common_words.size(), "hash index contains");
+
+  // The cost of keeping the hash index on insertion
+  std::function<void()> emplace_tree = [&common_words]() {
+    xsm::radix<int> rdx;
+    for (const std::string& word : common_words){
+      rdx.emplace(word, 1);
+    }
+  };
+
+  std::function<void()> emplace_hashed = [&common_words]() {
+    hashed_radix rdx;
+    for (const std::string& word : common_words){
+      rdx.emplace(word, 1);
+    }
+  };
+
+  benchmark::time(emplace_tree, "tree emplace");
+  benchmark::time(emplace_hashed, "hash index emplace");
+}
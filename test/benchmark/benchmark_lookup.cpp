@@ -1,6 +1,7 @@
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <random>
 #include "commonwords.hpp"
 #include "benchmark.hpp"
 #include "radix.hpp"
@@ -200,5 +201,87 @@ int main(){
 
   benchmark::time(const_count, "radix count const");
   benchmark::time(const_count_template, "radix template count const");
-}
 
+  // find() and lower_bound() with the first two bytes of the keys indexed at the root
+  typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+  xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::root_indexed<>>> i_rdx;
+
+  for (const std::string& word : common_words){
+    i_rdx.emplace(word, 1);
+  }
+
+  std::function<void()> const_find_indexed = [&common_words, &i_rdx]() {
+    for (const std::string& word : common_words){
+      std::as_const(i_rdx).find(word);
+    }
+  };
+
+  std::function<void()> const_lower_bound_indexed = [&common_words, &i_rdx]() {
+    for (const std::string& word : common_words){
+      std::as_const(i_rdx).lower_bound(word);
+    }
+  };
+
+  benchmark::time(const_find_indexed, "radix find const root indexed");
+  benchmark::time(const_lower_bound_indexed, "radix lower_bound const root indexed");
+
+  // find() on a skewed query stream, in which few words make up most of the lookups, with and
+  // without a cache of recently found elements
+  std::vector<std::string> skewed;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> uniform(1, common_words.size());
+  for (size_t i = 0; i < 10 * common_words.size(); ++i){
+    skewed.push_back(common_words[common_words.size() / uniform(rng) - 1]);
+  }
+
+  typedef xsm::radix_options<xsm::lookup_cached<>> cached_options;
+  xsm::radix<int,std::less<std::string>,std::allocator<std::pair<const std::string,int>>,cached_options> c_rdx;
+
+  for (const std::string& word : common_words){
+    c_rdx.emplace(word, 1);
+  }
+
+  std::function<void()> find_skewed = [&skewed, &rdx]() {
+    for (const std::string& word : skewed){
+      std::as_const(rdx).find(word);
+    }
+  };
+
+  std::function<void()> find_skewed_cached = [&skewed, &c_rdx]() {
+    for (const std::string& word : skewed){
+      std::as_const(c_rdx).find(word);
+    }
+  };
+
+  benchmark::time(find_skewed, "radix find const skewed");
+  benchmark::time(find_skewed_cached, "radix find const skewed lookup cached");
+  std::cout << "Lookup cache hits: " << c_rdx.cache_stats().hits << ", misses: " << c_rdx.cache_stats().misses << std::endl;
+
+  // find() and lower_bound() of keys in sorted order, from the root and from the previous result
+  std::vector<std::string> sorted_words = common_words;
+  std::sort(sorted_words.begin(), sorted_words.end());
+
+  std::function<void()> find_sorted = [&sorted_words, &rdx]() {
+    for (const std::string& word : sorted_words){
+      std::as_const(rdx).find(word);
+    }
+  };
+
+  std::function<void()> find_sorted_finger = [&sorted_words, &rdx]() {
+    auto hint = std::as_const(rdx).end();
+    for (const std::string& word : sorted_words){
+      hint = std::as_const(rdx).find(hint, word);
+    }
+  };
+
+  std::function<void()> lower_bound_sorted_finger = [&sorted_words, &rdx]() {
+    auto hint = std::as_const(rdx).end();
+    for (const std::string& word : sorted_words){
+      hint = std::as_const(rdx).lower_bound(hint, word);
+    }
+  };
+
+  benchmark::time(find_sorted, "radix find const sorted");
+  benchmark::time(find_sorted_finger, "radix find const sorted from previous");
+  benchmark::time(lower_bound_sorted_finger, "radix lower_bound const sorted from previous");
+}
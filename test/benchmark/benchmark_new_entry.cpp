@@ -41,6 +41,19 @@ int main(){
     benchmark::time(insert_many, "radix insert");
   }
 
+  // insert into set
+  {
+    xsm::radix_set<> set;
+
+    std::function<void()> insert_many_set = [common_words, set]() mutable {
+      for (const std::string& word : common_words){
+        set.insert(word);
+      }
+    };
+
+    benchmark::time(insert_many_set, "radix_set insert");
+  }
+
   std::sort(common_words.begin(), common_words.end());
 
   // Best hint
@@ -71,5 +84,42 @@ int main(){
     benchmark::time(emplace_many_poor_hint, "radix emplace_hint poor hint");
   }
 
+  // Range insert of sorted elements, which builds the tree bottom-up
+  {
+    std::vector<std::pair<std::string,bool>> elements;
+    for (const std::string& word : common_words){
+      elements.emplace_back(word, true);
+    }
+
+    std::function<void()> insert_sorted_range = [&elements]() {
+      xsm::radix<bool> rdx(elements.begin(), elements.end());
+    };
+
+    benchmark::time(insert_sorted_range, "radix range insert sorted");
+  }
+
+  // Bulk load against single insertions for a dictionary that does not fit into the caches
+  {
+    std::vector<std::pair<std::string,bool>> elements;
+    for (size_t i = 0; i < 1000000; ++i){
+      elements.emplace_back(common_words[i % common_words.size()] + "/" + std::to_string(i), true);
+    }
+    std::sort(elements.begin(), elements.end());
+
+    std::function<void()> emplace_sorted = [&elements]() {
+      xsm::radix<bool> rdx;
+      for (const auto& element : elements){
+        rdx.emplace(element);
+      }
+    };
+
+    std::function<void()> insert_sorted_range = [&elements]() {
+      xsm::radix<bool> rdx(elements.begin(), elements.end());
+    };
+
+    benchmark::time(emplace_sorted, "radix emplace 1000000 sorted");
+    benchmark::time(insert_sorted_range, "radix range insert 1000000 sorted");
+  }
+
 }
 
@@ -0,0 +1,66 @@
+#include <vector>
+#include <string>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include "radix.hpp"
+#include "commonwords.hpp"
+#include "benchmark.hpp"
+
+// Compares building a radix from keys in random order with a loop of emplace, with the sorting
+// range insert, and with insert_parallel on an increasing number of threads
+template <class Radix>
+void timeBuild(const std::vector<std::pair<std::string,int>>& elements, const std::string& name){
+  volatile size_t sink = 0;
+
+  std::function<void()> emplace_loop = [&]() {
+    Radix rdx;
+    for (const auto& [key, value] : elements){
+      rdx.emplace(key, value);
+    }
+    sink = rdx.size();
+  };
+
+  std::function<void()> range_insert = [&]() {
+    std::vector<std::pair<std::string,int>> sorted = elements;
+    std::sort(sorted.begin(), sorted.end());
+    Radix rdx(sorted.begin(), sorted.end());
+    sink = rdx.size();
+  };
+
+  benchmark::throughput(emplace_loop, name + " emplace loop", elements.size());
+  benchmark::throughput(range_insert, name + " sort and range insert", elements.size());
+
+  const unsigned hardware = std::max(std::thread::hardware_concurrency(), 1u);
+  for (unsigned threads = 1;; threads = std::min(threads * 2, hardware)){
+    std::function<void()> parallel = [&]() {
+      Radix rdx;
+      rdx.insert_parallel(elements.begin(), elements.end(), threads);
+      sink = rdx.size();
+    };
+    benchmark::throughput(parallel, name + " insert_parallel, " + std::to_string(threads) + " threads", elements.size());
+    if (threads == hardware){
+      break;
+    }
+  }
+}
+
+int main() {
+
+  // Import 10000 words
+  auto [common_words, import_success] = commonwords::readWords();
+  if (!import_success){
+    commonwords::failedImport();
+  }
+
+  std::vector<std::pair<std::string,int>> paths;
+  for (size_t i = 0; i < 1000000; ++i){
+    paths.emplace_back(common_words[i % common_words.size()] + "/" + common_words[(i * 7919) % common_words.size()]
+                       + "/" + std::to_string(i), static_cast<int>(i));
+  }
+  std::shuffle(paths.begin(), paths.end(), std::mt19937(42));
+  timeBuild<xsm::radix<int>>(paths, "1000000 paths");
+
+  typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+  timeBuild<xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::hash_indexed<>>>>(paths, "1000000 paths, hash index");
+}
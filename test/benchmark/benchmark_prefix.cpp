@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <vector>
+#include "radix.hpp"
+#include "commonwords.hpp"
+#include "benchmark.hpp"
+
+int main() {
+
+  // Import 10000 words
+  auto [common_words, import_success] = commonwords::readWords();
+  if (!import_success){
+    commonwords::failedImport();
+  }
+
+  // Keys sharing a long prefix, like URLs below a few directories
+  std::vector<std::string> urls;
+  size_t n_words = common_words.size();
+  for (size_t i = 0; i < n_words; ++i){
+    urls.push_back("https://www.example.com/" + common_words[i % 16] + "/" +
+                   common_words[(i / 16) % 16] + "/" + common_words[i]);
+  }
+
+  std::vector<std::string> sorted_urls = urls;
+  std::sort(sorted_urls.begin(), sorted_urls.end());
+  volatile size_t sink = 0;
+
+  // Benchmark for the common prefix of neighbouring keys
+  std::function<void()> prefix_mismatch = [&sorted_urls, &sink]() {
+    size_t n = 0;
+    for (size_t i = 1; i < sorted_urls.size(); ++i){
+      const std::string& a = sorted_urls[i-1];
+      const std::string& b = sorted_urls[i];
+      size_t length = std::min(a.size(), b.size());
+      n += std::mismatch(a.begin(), a.begin() + length, b.begin()).first - a.begin();
+    }
+    sink = n;
+  };
+
+  benchmark::time(prefix_mismatch, "Common prefix std::mismatch");
+
+  std::function<void()> prefix_blocks = [&sorted_urls, &sink]() {
+    size_t n = 0;
+    for (size_t i = 1; i < sorted_urls.size(); ++i){
+      n += xsm::detail::CommonPrefix(sorted_urls[i-1], sorted_urls[i]);
+    }
+    sink = n;
+  };
+
+  benchmark::time(prefix_blocks, "Common prefix blocks");
+
+  // Benchmark for insert and find of long prefix keys
+  std::function<void()> emplace_urls = [&urls]() {
+    xsm::radix<int> rdx;
+    for (auto& url : urls) {
+      rdx.emplace(url, 1);
+    }
+  };
+
+  benchmark::time(emplace_urls, "Emplace long prefix keys");
+
+  xsm::radix<int> rdx;
+  for (auto& url : urls) {
+    rdx.emplace(url, 1);
+  }
+
+  std::function<void()> find_urls = [&urls, &rdx, &sink]() {
+    size_t n = 0;
+    for (auto& url : urls) {
+      n += rdx.find(url)->second;
+    }
+    sink = n;
+  };
+
+  benchmark::time(find_urls, "Find long prefix keys");
+}
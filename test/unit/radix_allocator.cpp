@@ -0,0 +1,176 @@
+#include <string>
+#include <cassert>
+#include "radix.hpp"
+
+// Stateful allocator that counts the live allocations of all its copies
+struct Counter{
+  long live = 0;
+  long total = 0;
+};
+
+template <class T>
+struct Counting_allocator{
+  typedef T value_type;
+
+  Counter* counter;
+
+  explicit Counting_allocator(Counter& c) : counter(&c) {}
+  template <class U> Counting_allocator(const Counting_allocator<U>& other) : counter(other.counter) {}
+
+  T* allocate(size_t n){
+    ++counter->live;
+    ++counter->total;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* ptr, size_t n){
+    --counter->live;
+    std::allocator<T>().deallocate(ptr, n);
+  }
+};
+
+template <class T, class U>
+bool operator==(const Counting_allocator<T>& lhs, const Counting_allocator<U>& rhs){
+  return lhs.counter == rhs.counter;
+}
+
+template <class T, class U>
+bool operator!=(const Counting_allocator<T>& lhs, const Counting_allocator<U>& rhs){
+  return !(lhs == rhs);
+}
+
+typedef Counting_allocator<std::pair<const std::string,int>> counting_alloc;
+typedef xsm::radix<int,std::less<std::string>,counting_alloc> counting_radix;
+typedef xsm::pool_allocator<std::pair<const std::string,int>> pool_alloc;
+typedef xsm::radix<int,std::less<std::string>,pool_alloc> pool_radix;
+
+int main() {
+
+  // All nodes, child maps and edge labels are obtained from the allocator
+  Counter a_count;
+  Counter b_count;
+  {
+    counting_radix rdx{counting_alloc(a_count)};
+    assert(rdx.get_allocator() == counting_alloc(a_count));
+    for (int c = 1; c < 256; ++c){
+      rdx.emplace(std::string(1, static_cast<char>(c)) + "/a/long/label/that/spills", c);
+      rdx.emplace(std::string(1, static_cast<char>(c)) + "/a/long/label/that/is/split", -c);
+    }
+    assert(a_count.live > 3 * 255);
+    assert(rdx.at("z/a/long/label/that/spills") == 'z');
+
+    // Node handles keep the allocator of their node
+    auto nh = rdx.extract("z/a/long/label/that/spills");
+    assert(nh.get_allocator() == counting_alloc(a_count));
+
+    // ... and are spliced into trees with an equal allocator
+    counting_radix same{counting_alloc(a_count)};
+    long total = a_count.total;
+    same.insert(std::move(nh));
+    assert(nh.empty());
+    assert(same.at("z/a/long/label/that/spills") == 'z');
+    // Only the root of the formerly empty radix is allocated
+    assert(a_count.total == total + 1);
+
+    // Trees with a different allocator allocate a new node
+    counting_radix other{counting_alloc(b_count)};
+    other.insert(same.extract("z/a/long/label/that/spills"));
+    assert(other.at("z/a/long/label/that/spills") == 'z');
+    assert(b_count.live == 2);
+
+    // Node handles can be swapped
+    auto nh1 = rdx.extract("a/a/long/label/that/spills");
+    auto nh2 = other.extract("z/a/long/label/that/spills");
+    swap(nh1, nh2);
+    assert(nh1.key() == "z/a/long/label/that/spills");
+    assert(nh1.get_allocator() == counting_alloc(b_count));
+    assert(nh2.get_allocator() == counting_alloc(a_count));
+
+    // Allocator aware copy and move
+    counting_radix cpy(rdx, counting_alloc(b_count));
+    assert(cpy.size() == rdx.size());
+    assert(cpy.get_allocator() == counting_alloc(b_count));
+    counting_radix moved(std::move(cpy), counting_alloc(a_count));
+    assert(moved.size() == rdx.size());
+    assert(cpy.empty());
+    // Root of other and the node held by nh1, the emptied cpy holds no root
+    assert(b_count.live == 2);
+
+    rdx.clear();
+    assert(rdx.empty());
+  }
+  assert(a_count.live == 0);
+  assert(b_count.live == 0);
+
+  // Node pool
+  {
+    xsm::node_pool pool(1 << 16);
+    {
+      pool_radix rdx(pool);
+      for (int i = 0; i < 20000; ++i){
+        rdx.emplace("key" + std::to_string(i), i);
+      }
+      assert(pool.slab_count() > 1);
+      for (int i = 0; i < 20000; i += 7){
+        assert(rdx.at("key" + std::to_string(i)) == i);
+      }
+
+      // Containers on the same pool share nodes
+      {
+        pool_radix other(pool);
+        other.insert(rdx.extract("key42"));
+        assert(other.at("key42") == 42);
+        assert(!rdx.contains("key42"));
+      }
+
+      // Once no node is left in the pool, the slabs are freed at once
+      rdx.clear();
+      assert(pool.slab_count() == 1);
+      assert(pool.blocks_in_use() == 0);
+
+      rdx.emplace("key", 1);
+      assert(rdx.at("key") == 1);
+    }
+    assert(pool.blocks_in_use() == 0);
+  }
+
+  // Huge pages are optional, the pool falls back to regular pages
+  {
+    xsm::node_pool pool(0, true);
+    pool_radix rdx(pool);
+    rdx.emplace("huge", 1);
+    rdx.emplace("hugepage", 2);
+    assert(rdx.at("hugepage") == 2);
+  }
+
+  // Empty instances do not allocate, not even when they are moved
+  {
+    Counter count;
+    counting_radix rdx{counting_alloc(count)};
+    counting_radix moved(std::move(rdx));
+    counting_radix assigned{counting_alloc(count)};
+    assigned = std::move(moved);
+    assigned.swap(rdx);
+    static_assert(std::is_nothrow_move_constructible_v<counting_radix>);
+    static_assert(std::is_nothrow_default_constructible_v<xsm::radix<int>>);
+    assert(count.total == 0);
+    assert(rdx.empty() && rdx.begin() == rdx.end());
+    assert(rdx.find("key") == rdx.end());
+    auto [b_it, e_it] = rdx.complete("k");
+    assert(b_it == e_it);
+
+    // The first element allocates the root, clear() releases it again. end() stays the same
+    // throughout.
+    auto e = rdx.end();
+    rdx.emplace_hint(e, "key", 1);
+    assert(rdx.at("key") == 1);
+    assert(count.live == 2);
+    assert(e == rdx.end() && e != rdx.begin());
+    auto last = e;
+    assert((--last)->first == "key");
+    rdx.clear();
+    assert(count.live == 0);
+    assert(e == rdx.end() && rdx.begin() == rdx.end());
+  }
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+typedef std::pair<std::string,int> element;
+
+int main() {
+
+  // Keys that are prefixes of others, a leaf with children below a node without an element,
+  // long labels that leaves borrow from their key, and bytes above 0x7f
+  std::vector<std::string> keys = {
+    "a", "ab", "abc", "abcd", "abd", "b", "ba", "bab", "bb", "bba", "c",
+    "https://example.com/", "https://example.com/a", "https://example.com/b/c",
+    "https://example.com/b/long/label/that/spills", "https://example.org/", "https://example.org/x",
+    "\x7f", "\x80", "\xff", "\xff\xff"
+  };
+  std::vector<std::string> probes = {"", "aa", "abb", "abce", "bc", "https://", "https://example.com/b",
+                                     "https://example.net/", "z", "\xfe"};
+
+  std::vector<element> sorted;
+  map_type map;
+  for (size_t i = 0; i < keys.size(); ++i){
+    sorted.emplace_back(keys[i], static_cast<int>(i));
+    map.emplace(keys[i], static_cast<int>(i));
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs){ return lhs.first < rhs.first; });
+
+  // Sorted input, with the empty key and duplicates, which are dropped like by insert()
+  std::vector<element> with_duplicates = sorted;
+  with_duplicates.insert(with_duplicates.begin(), element("", -1));
+  with_duplicates.insert(with_duplicates.begin() + 3, element(with_duplicates[2].first, -2));
+  with_duplicates.emplace_back(sorted.back().first, -3);
+
+  // Input that is sorted only up to some point, and in reverse
+  std::vector<element> unsorted = sorted;
+  std::rotate(unsorted.begin(), unsorted.begin() + 7, unsorted.end());
+  std::vector<element> reversed = sorted;
+  std::reverse(reversed.begin(), reversed.end());
+
+  for (const auto* elements : {&sorted, &with_duplicates, &unsorted, &reversed}){
+    xsm::radix<int> rdx(elements->begin(), elements->end());
+    assertEqual(rdx, map, probes);
+
+    // The tree stays consistent under later modifications
+    assert(rdx.erase("ab") == 1 && rdx.erase("https://example.com/b/c") == 1);
+    rdx.emplace("abcx", 99);
+    auto it = rdx.find("a");
+    assert((++it)->first == "abc" && (++it)->first == "abcd" && (++it)->first == "abcx");
+    assert(rdx.lower_bound(std::string("https://example.com/b"))->first == "https://example.com/b/long/label/that/spills");
+  }
+
+  // The root index, the hash index and the leaf links are filled while the tree is built
+  {
+    xsm::radix<int,std::less<std::string>,std_alloc,
+               xsm::radix_options<xsm::root_indexed<>,xsm::hash_indexed<>,xsm::leaf_linked,xsm::lookup_cached<>>>
+        rdx(with_duplicates.begin(), with_duplicates.end());
+    assertEqual(rdx, map, probes);
+    auto [first, last] = rdx.complete("https://example.com/");
+    assert(std::distance(first, last) == 4);
+  }
+
+  // Nodes from a pool get compact links
+  {
+    xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+    typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+    {
+      xsm::radix<int,std::less<std::string>,compact_alloc> rdx(sorted.begin(), sorted.end(), compact_alloc(pool));
+      assertEqual(rdx, map, probes);
+    }
+    assert(pool.blocks_in_use() == 0);
+  }
+
+  // Other comparators insert one by one
+  {
+    xsm::radix<int,std::greater<std::string>> rdx{{"a", 1}, {"c", 2}, {"b", 3}, {"c", 4}};
+    assert(rdx.size() == 3 && rdx.begin()->first == "c" && rdx.at("c") == 2);
+    assert(std::prev(rdx.end())->first == "a");
+  }
+
+  // The tree is the same as the one built by single insertions
+  {
+    Counter bulk_count;
+    Counter single_count;
+    failing_radix bulk(sorted.begin(), sorted.end(), failing_alloc(bulk_count));
+    failing_radix single{failing_alloc(single_count)};
+    for (const auto& element : sorted){
+      single.insert(element);
+    }
+    assert(bulk_count.live == single_count.live);
+
+    // Copies of a radix are built bottom-up
+    failing_radix cpy(single);
+    assert(single_count.live == bulk_count.live * 2);
+    assert(std::equal(cpy.begin(), cpy.end(), single.begin(), single.end()));
+  }
+
+  // A failed build leaves no allocations behind, whether it fails on the first node, on a label
+  // or on a child map
+  for (long limit : {0L, 1L, 2L, 5L, 20L}){
+    Counter count;
+    count.limit = limit;
+    try {
+      failing_radix rdx(sorted.begin(), sorted.end(), failing_alloc(count));
+      assert(false);
+    }
+    catch (const std::bad_alloc&) {
+      assert(count.live == 0);
+    }
+  }
+
+  // Single pass input, an initializer list, and insertion into a radix that is not empty
+  std::istringstream words("apple banana banana cherry date apple");
+  xsm::radix_set<> set{std::istream_iterator<std::string>(words), std::istream_iterator<std::string>()};
+  assert(set.size() == 4);
+  assert(*set.begin() == "apple" && *std::prev(set.end()) == "date");
+
+  xsm::radix<int> rdx{{"x", 1}, {"xy", 2}, {"y", 3}};
+  assert(rdx.size() == 3 && rdx.at("xy") == 2);
+  rdx.insert(sorted.begin(), sorted.end());
+  assert(rdx.size() == sorted.size() + 3);
+  assert(rdx.at("abc") == 2 && rdx.at("y") == 3);
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <map>
+#include <string>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+typedef xsm::pool_allocator<value_type> pool_alloc;
+typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+typedef xsm::radix<int,std::less<std::string>,compact_alloc> compact_radix;
+typedef xsm::radix<int,std::less<std::string>,pool_alloc> pool_radix;
+
+int main() {
+
+  // Links are half the size of pointers. Nodes are complete once their radix is.
+  static_assert(sizeof(compact_radix) == sizeof(pool_radix));
+  static_assert(sizeof(xsm::detail::Inner_node<int,std::less<std::string>,compact_alloc,xsm::radix_options<>>)
+      < sizeof(xsm::detail::Inner_node<int,std::less<std::string>,pool_alloc,xsm::radix_options<>>));
+  // Non-leaf nodes fit into a single cache line
+  static_assert(sizeof(xsm::detail::Inner_node<int,std::less<std::string>,pool_alloc,xsm::radix_options<>>) <= 64);
+
+  xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+  assert(pool.contiguous());
+  {
+    const std::vector<std::string> probes = {"", "a", "apple", "apples", "apricot", "https://example.com/", "x", "z"};
+
+    // A leaf with children, a split edge and long labels
+    compact_radix rdx(pool);
+    map_type map{{"app", 1}, {"apple", 2}, {"applesauce", 3}, {"apricot", 4},
+                 {"https://example.com/a", 5}, {"https://example.com/b/long/label/that/spills", 6}};
+    rdx.insert(map.begin(), map.end());
+    assertEqual(rdx, map, probes);
+
+    // Node handles of a leaf with children, whose children stay in the tree
+    auto nh = rdx.extract("apple");
+    assert(nh.mapped() == 2);
+    assert(rdx.at("applesauce") == 3 && !rdx.contains("apple"));
+    rdx.insert(std::move(nh));
+    assertEqual(rdx, map, probes);
+
+    // Removing "app" leaves "ap" with the children "ple" and "ricot"
+    rdx.erase("app");
+    map.erase("app");
+    assertEqual(rdx, map, probes);
+
+    // The child maps of the root and of "x" take every layout, whose children are links as well
+    for (int c = 1; c < 256; c += 2){
+      std::string key(1, static_cast<char>(c));
+      rdx.emplace("x" + key, c);
+      map.emplace("x" + key, c);
+      rdx.emplace(key + "suffix", -c);
+      map.emplace(key + "suffix", -c);
+    }
+    assertEqual(rdx, map, probes);
+    for (int c = 1; c < 256; c += 4){
+      std::string key(1, static_cast<char>(c));
+      assert(rdx.erase("x" + key) == 1 && rdx.erase(key + "suffix") == 1);
+      map.erase("x" + key);
+      map.erase(key + "suffix");
+    }
+    assertEqual(rdx, map, probes);
+
+    // Whole trees are exchanged without touching the links
+    compact_radix other(pool);
+    other.emplace("other", 1);
+    rdx.swap(other);
+    assert(rdx.size() == 1);
+    other.swap(rdx);
+    assertEqual(rdx, map, probes);
+
+    compact_radix cpy = rdx;
+    assertEqual(cpy, map, probes);
+  }
+  assert(pool.blocks_in_use() == 0);
+
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+int main() {
+
+  // "ap" has the children "p" and "ricot", the leaf "app" has the child "le", which has the child
+  // "sauce", and the labels below "https://example." are longer than the inline storage of a label
+  const map_type elements{{"a", 1}, {"ab", 2}, {"abc", 3}, {"abd", 4}, {"app", 5}, {"apple", 6}, {"applesauce", 7},
+                          {"apricot", 8}, {"b", 9}, {"https://example.com/a", 10}, {"https://example.com/a/b", 11},
+                          {"https://example.com/b/long/label/that/spills", 12}, {"https://example.org/", 13}};
+  const std::vector<std::string> probes = {"", "a", "ab", "abc", "ap", "app", "appl", "apple", "apples", "apr", "b",
+                                           "c", "https://example.", "https://example.com/", "https://example.com/a/",
+                                           "https://example.com/b", "https://example.org/", "z"};
+
+  // Erases the range between the elements with two keys, the empty key standing for the end. The
+  // erased elements are inserted again afterwards.
+  for (const auto& [first, last] : {std::pair<std::string,std::string>("a", ""),
+                                    {"ab", "ab"},                                 // Empty range
+                                    {"ab", "app"},                                // Subtree of a leaf
+                                    {"abc", "apple"},                             // Ends below a leaf
+                                    {"app", "applesauce"},                        // Leaves above the last
+                                    {"apple", "b"},
+                                    {"abd", "apricot"},
+                                    {"https://example.com/a/b", "https://example.org/"}, // Long labels
+                                    {"https://example.com/a", ""},
+                                    {"b", ""}}){
+    xsm::radix<int> rdx(elements.begin(), elements.end());
+    map_type map = elements;
+    auto r_last = last.empty()? rdx.cend() : rdx.find(last);
+    auto m_last = last.empty()? map.end() : map.find(last);
+    auto it = rdx.erase(rdx.find(first), r_last);
+    auto m_it = map.erase(map.find(first), m_last);
+    assert((m_it == map.end())? it == rdx.end() : it->first == m_it->first);
+    assertEqual(rdx, map, probes);
+
+    rdx.insert(elements.begin(), elements.end());
+    assertEqual(rdx, elements, probes);
+  }
+
+  // Erases the elements below a prefix, which are also the range of complete() if there are any
+  for (const auto& [prefix, erased] : {std::pair<std::string,size_t>("", 13),
+                                      {"ab", 3},                   // Label boundary
+                                      {"appl", 2},                 // Inside a label
+                                      {"apple", 2},                // Leaf that has children
+                                      {"applesauce", 1},           // Leaf without children
+                                      {"https://example.co", 3},   // Inside a long label
+                                      {"https://example.com/a/", 1},
+                                      {"apz", 0},
+                                      {"c", 0}}){
+    xsm::radix<int> rdx(elements.begin(), elements.end());
+    map_type map = elements;
+    assert(std::erase_if(map, [&](const auto& entry){ return entry.first.starts_with(prefix); }) == erased);
+    assert(rdx.erase_prefix(prefix) == erased);
+    assertEqual(rdx, map, probes);
+    rdx.insert(elements.begin(), elements.end());
+    assertEqual(rdx, elements, probes);
+
+    if (erased != 0 && !prefix.empty()){
+      auto [b_it, e_it] = rdx.complete(prefix);
+      rdx.erase(b_it, e_it);
+      assertEqual(rdx, map, probes);
+    }
+  }
+
+  // The root index, the hash index, the leaf links and the lookup cache forget the erased elements
+  {
+    typedef xsm::radix<int,std::less<std::string>,std_alloc,
+                       xsm::radix_options<xsm::root_indexed<>,xsm::hash_indexed<>,xsm::leaf_linked,xsm::lookup_cached<>>> radix;
+    radix rdx(elements.begin(), elements.end());
+    for (const std::string& probe : probes){
+      rdx.contains(probe);
+    }
+    map_type map = elements;
+    rdx.erase(rdx.find("abc"), rdx.find("apple"));
+    map.erase(map.find("abc"), map.find("apple"));
+    assert(rdx.erase_prefix("https://example.co") == 3);
+    std::erase_if(map, [](const auto& entry){ return entry.first.starts_with("https://example.co"); });
+    assertEqual(rdx, map, probes);
+    rdx.insert(elements.begin(), elements.end());
+    assertEqual(rdx, elements, probes);
+  }
+
+  // Nodes from a pool are returned to it
+  {
+    xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+    typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+    {
+      xsm::radix<int,std::less<std::string>,compact_alloc> rdx(elements.begin(), elements.end(), compact_alloc(pool));
+      rdx.erase(rdx.find("abc"), rdx.find("apple"));
+      assert(rdx.erase_prefix("https://example.co") == 3);
+      assert(rdx.size() == elements.size() - 6);
+      rdx.erase(rdx.begin(), rdx.end());
+      assert(rdx.empty() && rdx.begin() == rdx.end());
+    }
+    assert(pool.blocks_in_use() == 0);
+  }
+
+  // Other comparators erase in the order of the tree
+  {
+    xsm::radix<int,std::greater<std::string>> rdx{{"a", 1}, {"ba", 2}, {"bb", 3}, {"c", 4}, {"d", 5}};
+    auto it = rdx.erase(std::next(rdx.cbegin()), std::next(rdx.cbegin(), 3));
+    assert(it->first == "ba");
+    assert(rdx.size() == 3 && rdx.begin()->first == "d" && std::prev(rdx.end())->first == "a");
+    assert(rdx.erase_prefix("b") == 1);
+    assert(rdx.size() == 2 && std::next(rdx.begin())->first == "a");
+  }
+
+  // Sets, and sizes after a split
+  {
+    xsm::radix_set<> set{"a", "abc", "abd", "b", "bc"};
+    xsm::radix_set<> upper = set.split(std::string("b"));
+    assert(set.erase_prefix(std::string_view("ab")) == 2);
+    assert(upper.erase_prefix("b") == 2);
+    assert(set.size() == 1 && upper.empty());
+  }
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <map>
+#include <string>
+#include <cassert>
+#include "radix_fixture.hpp"
+#include "custom_comp.hpp"
+
+int main() {
+
+  const std::string missing = std::string("x") + '\0';
+
+  // Children of the root node are inserted in front of the others, and children of "x" behind
+  // them, and both pass through every node size when growing
+  xsm::radix<int> rdx;
+  map_type map;
+  for (int c = 255; c > 0; c -= 2){
+    std::string key(1, static_cast<char>(c));
+    rdx.emplace(key, c);
+    map.emplace(key, c);
+    rdx.emplace("x" + std::string(1, static_cast<char>(256 - c)), -c);
+    map.emplace("x" + std::string(1, static_cast<char>(256 - c)), -c);
+    assertEqual(rdx, map, {missing, "x", "y"});
+  }
+  // Bytes in between fill the gaps of the larger layouts
+  for (int c = 2; c < 256; c += 2){
+    std::string key(1, static_cast<char>(c));
+    rdx.emplace(key, c);
+    map.emplace(key, c);
+  }
+  assertEqual(rdx, map, {missing, "x", "y"});
+  assert(!rdx.contains(missing) && rdx.find(missing) == rdx.end());
+
+  // Lower bound across a wide node
+  assert(rdx.lower_bound(missing)->first == std::string("x") + static_cast<char>(1));
+
+  // Shrinking passes through every node size again, down to a single child
+  for (int c = 1; c < 256; c += 3){
+    std::string key(1, static_cast<char>(c));
+    assert(rdx.erase(key) == map.erase(key));
+    assert(rdx.erase("x" + key) == map.erase("x" + key));
+    assertEqual(rdx, map, {missing, "x", "y"});
+  }
+  while (map.size() > 1){
+    assert(rdx.erase(map.begin()->first) == 1);
+    map.erase(map.begin());
+    assertEqual(rdx, map, {missing, "x", "y"});
+  }
+  assert(rdx.erase(map.begin()->first) == 1);
+  assert(rdx.empty() && rdx.begin() == rdx.end());
+
+  // Comparator without byte order specialisation, whose children are kept in the order of the
+  // comparator in every node size
+  {
+    xsm::radix<int,xsm::comp::CompK> k_rdx;
+    map_type k_map;
+    for (int c = 200; c > 100; c -= 2){
+      std::string key = "k" + std::string(1, static_cast<char>(c));
+      k_rdx.emplace(key, c);
+      k_map.emplace(key, c);
+      assertEqual(k_rdx, k_map, {"k", "k~", "l"});
+    }
+    for (int c = 101; c < 200; c += 4){
+      std::string key = "k" + std::string(1, static_cast<char>(c));
+      k_rdx.emplace(key, c);
+      k_map.emplace(key, c);
+    }
+    assertEqual(k_rdx, k_map, {"k", "k~", "l"});
+    while (k_map.size() > 2){
+      assert(k_rdx.erase(std::prev(k_map.end())->first) == 1);
+      k_map.erase(std::prev(k_map.end()));
+      assertEqual(k_rdx, k_map, {"k", "k~", "l"});
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <string>
+#include <ranges>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cassert>
+#include "radix.hpp"
+
+typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+
+// Batched lookups must give the same results as single lookups, for keys that are stored and
+// keys that are not
+template <class Radix, class Keys>
+void findMany(const Radix& rdx, const Keys& probes){
+  std::vector<typename Radix::const_iterator> found(probes.size());
+  std::unique_ptr<bool[]> contained(new bool[probes.size()]);
+  rdx.find_many(probes, std::span(found));
+  rdx.contains_many(probes, std::span(contained.get(), probes.size()));
+
+  for (size_t i = 0; i < probes.size(); ++i){
+    assert(found[i] == rdx.find(probes[i]));
+    assert(contained[i] == rdx.contains(probes[i]));
+  }
+}
+
+template <class Radix>
+void findMany(Radix& rdx){
+  std::vector<std::string> keys;
+  for (int i = 0; i < 500; ++i){
+    keys.push_back(std::to_string(i * 7919 % 1000));
+    keys.push_back("prefix/" + std::to_string(i));
+  }
+  for (const std::string& key : keys){
+    rdx.emplace(key, static_cast<int>(key.size()));
+  }
+
+  // Fewer keys than interleaved descents, and no keys at all
+  std::vector<std::string> probes = {"1", "", "prefix"};
+  findMany(rdx, probes);
+  findMany(rdx, std::vector<std::string>());
+
+  // Keys that end in inner nodes, in labels, and beyond leaves
+  for (int i = 0; i < 1200; ++i){
+    probes.push_back(std::to_string(i));
+    probes.push_back("prefix/" + std::to_string(i));
+    probes.push_back("prefix/" + std::to_string(i) + "/");
+  }
+  for (const char* probe : {"p", "pre", "prefix/", "prefiy", "\xff"}){
+    probes.push_back(probe);
+  }
+  findMany(rdx, probes);
+
+  // Other key types
+  std::vector<std::string_view> views(probes.begin(), probes.end());
+  findMany(rdx, views);
+  std::vector<const char*> c_strings;
+  for (const std::string& probe : probes){
+    c_strings.push_back(probe.c_str());
+  }
+  findMany(rdx, c_strings);
+  findMany(rdx, std::span<const std::string_view>(views).subspan(10, 100));
+
+  // Keys that are built on access and do not outlive the lookup
+  auto built = std::views::iota(0, 1200) | std::views::transform([](int i){ return "prefix/" + std::to_string(i); });
+  findMany(rdx, built);
+
+  // Mutable iterators
+  std::vector<typename Radix::iterator> found(2);
+  rdx.find_many(std::vector<std::string_view>{"prefix/1", "prefix/1000"}, std::span(found));
+  assert(found[0] != rdx.end() && found[1] == rdx.end());
+  found[0]->second = 100;
+  assert(rdx.at("prefix/1") == 100);
+
+  // Empty radix
+  rdx.clear();
+  findMany(rdx, probes);
+}
+
+int main() {
+
+  {
+    xsm::radix<int> rdx;
+    findMany(rdx);
+  }
+  {
+    xsm::radix<int,std::greater<std::string>> rdx;
+    findMany(rdx);
+  }
+  // A descent that starts below the root, and lookups answered by the cache or the hash index
+  {
+    xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::root_indexed<1>>> rdx;
+    findMany(rdx);
+  }
+  {
+    xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::hash_indexed<>,xsm::lookup_cached<>>> rdx;
+    findMany(rdx);
+  }
+
+  // Compact links
+  xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+  {
+    xsm::radix<int,std::less<std::string>,xsm::compact_pool_allocator<std::pair<const std::string,int>>> rdx{
+        xsm::compact_pool_allocator<std::pair<const std::string,int>>(pool)};
+    findMany(rdx);
+  }
+
+  // Sets
+  xsm::radix_set<> set;
+  for (const char* key : {"a", "ab", "abc", "b"}){
+    set.insert(key);
+  }
+  findMany(set, std::vector<std::string>{"", "a", "aa", "ab", "abc", "abcd", "b", "c"});
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <string>
+#include <vector>
+#include <cassert>
+#include "radix.hpp"
+
+// Finger search must give the same results as a search from the root, for every hint
+template <class Radix>
+void fingerSearch(const Radix& rdx, const std::vector<std::string>& probes){
+  std::vector<typename Radix::const_iterator> hints;
+  for (auto it = rdx.begin(); it != rdx.end(); ++it){
+    hints.push_back(it);
+  }
+  hints.push_back(rdx.end());
+
+  for (const auto& hint : hints){
+    for (const std::string& probe : probes){
+      assert(rdx.find(hint, probe) == rdx.find(probe));
+      assert(rdx.lower_bound(hint, std::string_view(probe)) == rdx.lower_bound(probe));
+
+      // complete() is only defined if there are completions of a non-empty key
+      auto lb = rdx.lower_bound(probe);
+      if (!probe.empty() && lb != rdx.end() && lb->first.starts_with(probe)){
+        assert(rdx.complete(hint, probe.c_str()) == rdx.complete(probe));
+      }
+    }
+  }
+}
+
+int main() {
+
+  std::vector<std::string> keys = {
+    "a", "ab", "abc", "abcd", "abd", "b", "ba", "bab", "bb", "bba", "c",
+    "https://example.com/", "https://example.com/a", "https://example.com/b/c",
+    "https://example.org/", "https://example.org/x"
+  };
+  std::vector<std::string> probes = keys;
+  for (const char* probe : {"", "aa", "abb", "abce", "bc", "bz", "d", "https://", "https://example.com/b",
+                            "https://example.net/", "https://example.org/y", "z", "\x80"}){
+    probes.push_back(probe);
+  }
+
+  xsm::radix<int> rdx;
+  for (size_t i = 0; i < keys.size(); ++i){
+    rdx.emplace(keys[i], static_cast<int>(i));
+  }
+  fingerSearch(rdx, probes);
+
+  // Non-constant access returns mutable iterators
+  auto it = rdx.find(rdx.find("abc"), "abd");
+  it->second = 100;
+  assert(rdx.at("abd") == 100);
+  assert(rdx.lower_bound(it, "abz")->first == "b");
+  auto [b_it, e_it] = rdx.complete(it, "ab");
+  assert(b_it->first == "ab" && std::distance(b_it, e_it) == 4);
+
+  // Finger search with a root index
+  typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+  xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::root_indexed<>>> i_rdx;
+  for (size_t i = 0; i < keys.size(); ++i){
+    i_rdx.emplace(keys[i], static_cast<int>(i));
+  }
+  fingerSearch(i_rdx, probes);
+
+  // Comparators other than the byte order search from the root
+  xsm::radix<int,std::greater<std::string>> g_rdx;
+  for (size_t i = 0; i < keys.size(); ++i){
+    g_rdx.emplace(keys[i], static_cast<int>(i));
+  }
+  assert(g_rdx.find(g_rdx.begin(), "abc")->second == 2);
+  assert(g_rdx.lower_bound(g_rdx.begin(), "abcc") == g_rdx.lower_bound(std::string("abcc")));
+
+  return 0;
+}
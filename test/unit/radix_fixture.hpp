@@ -0,0 +1,88 @@
+//
+//  radix_fixture.hpp
+//
+//  Allocator and checks shared by the unit tests
+//
+
+#ifndef radix_fixture_hpp
+#define radix_fixture_hpp
+
+#include <map>
+#include <new>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include "radix.hpp"
+
+// Allocator that counts the live allocations of all its copies on any thread, and fails once a
+// limit of allocations is reached. Copies that share a counter are equal.
+struct Counter{
+  std::atomic<long> live = 0;
+  std::atomic<long> limit = -1;
+};
+
+template <class T>
+struct Failing_allocator{
+  typedef T value_type;
+
+  Counter* counter;
+
+  explicit Failing_allocator(Counter& c) : counter(&c) {}
+  template <class U> Failing_allocator(const Failing_allocator<U>& other) : counter(other.counter) {}
+
+  T* allocate(size_t n){
+    long limit = counter->limit;
+    while (limit != 0 && !counter->limit.compare_exchange_weak(limit, limit - 1)) {}
+    if (limit == 0){
+      throw std::bad_alloc();
+    }
+    ++counter->live;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* ptr, size_t n){
+    --counter->live;
+    std::allocator<T>().deallocate(ptr, n);
+  }
+};
+
+template <class T, class U>
+bool operator==(const Failing_allocator<T>& lhs, const Failing_allocator<U>& rhs){
+  return lhs.counter == rhs.counter;
+}
+
+template <class T, class U>
+bool operator!=(const Failing_allocator<T>& lhs, const Failing_allocator<U>& rhs){
+  return !(lhs == rhs);
+}
+
+typedef std::pair<const std::string,int> value_type;
+typedef Failing_allocator<value_type> failing_alloc;
+typedef xsm::radix<int,std::less<std::string>,failing_alloc> failing_radix;
+typedef std::allocator<value_type> std_alloc;
+typedef std::map<std::string,int> map_type;
+
+// Compares the order in both directions and the lookups of a radix with a std::map, and their
+// lookups and bounds at the probes
+template <class Radix, class Map>
+void assertEqual(const Radix& rdx, const Map& map, const std::vector<std::string>& probes = {}){
+  assert(rdx.size() == map.size());
+  assert(std::equal(rdx.begin(), rdx.end(), map.begin(), map.end()));
+  assert(std::equal(rdx.rbegin(), rdx.rend(), map.rbegin(), map.rend()));
+  for (const auto& entry : map){
+    assert(rdx.find(entry.first)->second == entry.second);
+  }
+  for (const std::string& probe : probes){
+    auto m_it = map.find(probe);
+    assert((m_it == map.end())? !rdx.contains(probe) : rdx.at(probe) == m_it->second);
+    auto m_lb = map.lower_bound(probe);
+    auto r_lb = rdx.lower_bound(probe);
+    assert((m_lb == map.end())? r_lb == rdx.end() : r_lb->first == m_lb->first);
+    auto m_ub = map.upper_bound(probe);
+    auto r_ub = rdx.upper_bound(probe);
+    assert((m_ub == map.end())? r_ub == rdx.end() : r_ub->first == m_ub->first);
+  }
+}
+
+#endif
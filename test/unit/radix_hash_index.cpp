@@ -0,0 +1,124 @@
+#include <map>
+#include <string>
+#include <vector>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::hash_indexed<>>> hashed_radix;
+
+// Hash that puts all keys into the same probe sequence
+struct Colliding_hash{
+  size_t operator()(std::string_view) const { return 7; }
+};
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::hash_indexed<Colliding_hash>>> colliding_radix;
+
+typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+typedef xsm::radix<int,std::less<std::string>,compact_alloc,xsm::radix_options<xsm::hash_indexed<>>> compact_hashed_radix;
+
+int main() {
+
+  const std::vector<std::string> probes = {"", "a", "ab", "abc", "abcd", "abd", "b", "p", "prefix", "prefix/",
+                                           "prefix/5", "prefix/8", "prefix/25", "zz"};
+
+  {
+    hashed_radix rdx;
+    map_type map;
+
+    // Insertions that grow the index several times, with and without hint
+    for (int i = 0; i < 300; ++i){
+      rdx.emplace(std::to_string(i * 7919 % 1000), i);
+      map.emplace(std::to_string(i * 7919 % 1000), i);
+      rdx.emplace_hint(rdx.end(), "prefix/" + std::to_string(i), -i);
+      map.emplace("prefix/" + std::to_string(i), -i);
+    }
+    assertEqual(rdx, map, probes);
+
+    // Lookups by other key types go through the index as well
+    assert(rdx.contains(std::string_view("prefix/5")) && rdx.count("prefix/5") == 1);
+    assert(!rdx.contains(std::string_view("prefix")) && rdx.count("prefix/300") == 0);
+
+    // A node handle leaves the index and joins it again
+    auto nh = rdx.extract("prefix/5");
+    assert(!rdx.contains("prefix/5") && rdx.find("prefix/5") == rdx.end());
+    rdx.insert(rdx.begin(), std::move(nh));
+    assertEqual(rdx, map, probes);
+
+    // Removals by key, by iterator and by range leave no stale entries
+    assert(rdx.erase("prefix/25") == 1);
+    map.erase("prefix/25");
+    rdx.erase(rdx.find("prefix/8"));
+    map.erase("prefix/8");
+    rdx.erase(rdx.lower_bound("prefix/2"), rdx.lower_bound("prefix/3"));
+    map.erase(map.lower_bound("prefix/2"), map.lower_bound("prefix/3"));
+    assertEqual(rdx, map, probes);
+
+    // The index is copied, moved and swapped with the tree
+    hashed_radix cpy = rdx;
+    assertEqual(cpy, map, probes);
+    hashed_radix other;
+    other.swap(cpy);
+    assertEqual(other, map, probes);
+    assertEqual(cpy, map_type(), probes);
+    hashed_radix moved(std::move(other));
+    assertEqual(moved, map, probes);
+    assertEqual(other, map_type(), probes);
+
+    rdx.clear();
+    assertEqual(rdx, map_type(), probes);
+    rdx.emplace("p", 1);
+    assert(rdx.at("p") == 1);
+  }
+
+  // All keys share one probe sequence, so lookups of missing keys and removals have to step
+  // over the entries of other keys. Prefixes of keys and leaves with children are in the index
+  // like any other element.
+  {
+    colliding_radix rdx;
+    map_type map{{"a", 1}, {"ab", 2}, {"abc", 3}, {"abd", 4}, {"b", 5}};
+    for (const auto& entry : map){
+      rdx.insert(entry);
+    }
+    assertEqual(rdx, map, probes);
+    assert(rdx.erase("ab") == 1);
+    map.erase("ab");
+    assertEqual(rdx, map, probes);
+    rdx.emplace("ab", 6);
+    rdx.erase("a");
+    map.emplace("ab", 6);
+    map.erase("a");
+    assertEqual(rdx, map, probes);
+    auto nh = rdx.extract("abc");
+    rdx.insert(std::move(nh));
+    assertEqual(rdx, map, probes);
+
+    // ... also while the index grows, and when many entries are removed
+    for (int i = 0; i < 100; ++i){
+      rdx.emplace("k" + std::to_string(i), i);
+      map.emplace("k" + std::to_string(i), i);
+    }
+    assertEqual(rdx, map, probes);
+    for (int i = 0; i < 100; i += 3){
+      assert(rdx.erase("k" + std::to_string(i)) == 1);
+      map.erase("k" + std::to_string(i));
+    }
+    assertEqual(rdx, map, probes);
+  }
+
+  // The index is allocated from the same memory as the nodes, with compact links
+  xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+  {
+    compact_hashed_radix rdx{compact_alloc(pool)};
+    map_type map;
+    for (int i = 0; i < 100; ++i){
+      rdx.emplace("prefix/" + std::to_string(i), i);
+      map.emplace("prefix/" + std::to_string(i), i);
+    }
+    assertEqual(rdx, map, probes);
+    rdx.erase(rdx.lower_bound("prefix/2"), rdx.lower_bound("prefix/3"));
+    map.erase(map.lower_bound("prefix/2"), map.lower_bound("prefix/3"));
+    assertEqual(rdx, map, probes);
+  }
+  assert(pool.blocks_in_use() == 0);
+
+  return 0;
+}
@@ -63,6 +63,26 @@ int main() {
     assert((*it).first == keys[i]);
     --i;
   }
+
+  // Iterators stay valid when siblings are inserted or erased before them
+  {
+    radix wide;
+    for (char c = 'b'; c <= 'y'; c += 2){
+      wide.emplace(std::string(1, c), true);
+    }
+    auto it = wide.find("h");
+    auto rit = wide.find("r");
+    for (char c = 'a'; c <= 'z'; c += 2){
+      wide.emplace(std::string(1, c), true);
+    }
+    assert((++it)->first == "i");
+    assert((--rit)->first == "q");
+    wide.erase("a");
+    wide.erase("c");
+    assert((++it)->first == "j");
+    assert((--rit)->first == "p");
+    assert((--it)->first == "i");
+  }
   return 0;
 }
 
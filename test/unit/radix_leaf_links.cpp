@@ -0,0 +1,86 @@
+#include <map>
+#include <string>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::leaf_linked>> linked_radix;
+typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+typedef xsm::radix<int,std::less<std::string>,compact_alloc,xsm::radix_options<xsm::leaf_linked>> compact_linked_radix;
+
+int main() {
+
+  // Links are stored in leaf nodes only
+  static_assert(sizeof(linked_radix) == sizeof(xsm::radix<int>));
+  static_assert(sizeof(xsm::detail::Inner_node<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::leaf_linked>>)
+      == sizeof(xsm::detail::Inner_node<int,std::less<std::string>,std_alloc,xsm::radix_options<>>));
+
+  const std::vector<std::string> probes = {"", "a", "asuf", "asuffi", "b", "z"};
+
+  {
+    linked_radix rdx;
+    map_type map;
+
+    // An element that splits an edge, one that becomes the prefix of others, and one inserted
+    // with a hint, each linked between its neighbours
+    rdx.emplace("asuffix", 1);
+    rdx.emplace("asuffiy", 2);
+    rdx.emplace_hint(rdx.end(), "asuf", 3);
+    rdx.emplace("a", 4);
+    rdx.emplace("b", 5);
+    map = {{"a", 4}, {"asuf", 3}, {"asuffix", 1}, {"asuffiy", 2}, {"b", 5}};
+    assertEqual(rdx, map, probes);
+
+    // Complete and equal_range step along the links
+    auto [b_it, e_it] = rdx.complete("a");
+    assert(b_it->first == "a");
+    assert((++b_it)->first == "asuf");
+    assert((++b_it)->first == "asuffix");
+    assert((++b_it)->first == "asuffiy");
+    assert(++b_it == e_it && e_it->first == "b");
+    auto [l_it, u_it] = rdx.equal_range(std::string("asuf"));
+    assert(l_it->first == "asuf" && ++l_it == u_it);
+
+    // Extracted elements leave the list, and join it again when inserted
+    auto nh = rdx.extract("asuf");
+    assert(!rdx.contains("asuf"));
+    assert((++rdx.find("a"))->first == "asuffix");
+    rdx.insert(std::move(nh));
+    assertEqual(rdx, map, probes);
+
+    // Erasing the first, the last and a leaf with children relinks the neighbours
+    rdx.erase("a");
+    rdx.erase("b");
+    rdx.erase("asuf");
+    map = {{"asuffix", 1}, {"asuffiy", 2}};
+    assertEqual(rdx, map, probes);
+
+    // Copies link their own leaves
+    linked_radix cpy = rdx;
+    rdx.clear();
+    assertEqual(cpy, map, probes);
+  }
+
+  // Leaf links are compact if the allocator asks for it, also in child maps of every layout
+  xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+  {
+    compact_linked_radix rdx{compact_alloc(pool)};
+    map_type map;
+    for (int c = 1; c < 256; ++c){
+      std::string key(1, static_cast<char>(c));
+      rdx.emplace(key + "suffix", c);
+      map.emplace(key + "suffix", c);
+      rdx.emplace_hint(rdx.end(), key, -c);
+      map.emplace(key, -c);
+    }
+    assertEqual(rdx, map, probes);
+    for (int c = 1; c < 256; c += 3){
+      std::string key(1, static_cast<char>(c));
+      assert(rdx.erase(key) == 1);
+      map.erase(key);
+    }
+    assertEqual(rdx, map, probes);
+  }
+  assert(pool.blocks_in_use() == 0);
+
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <string>
+#include <vector>
+#include <cassert>
+#include "radix.hpp"
+
+// Keys with long common prefixes produce edge labels that do not fit inline
+int main() {
+
+  std::vector<std::string> keys = {
+    "https://example.com/",
+    "https://example.com/index.html",
+    "https://example.com/images/banner.png",
+    "https://example.com/images/logo.png",
+    "https://example.org/a/very/long/path/that/is/not/split",
+    "https://example.org/a/very/long/path/that/is/split/here",
+    "short",
+    "shorter"
+  };
+
+  xsm::radix<int> rdx;
+  for (size_t i = 0; i < keys.size(); ++i){
+    rdx.emplace(keys[i], static_cast<int>(i));
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i){
+    assert(rdx.at(keys[i]) == static_cast<int>(i));
+  }
+  assert(!rdx.contains("https://example.com/images/"));
+  assert(!rdx.contains("https://example.org/a/very/long/path/that/is/"));
+
+  // Removing a node merges the labels of its parent and child
+  rdx.erase("https://example.com/images/banner.png");
+  assert(rdx.find("https://example.com/images/logo.png")->second == 3);
+
+  rdx.erase("https://example.com/");
+  assert(rdx.find("https://example.com/index.html")->second == 1);
+
+  // Node handles keep their key when moved between trees
+  xsm::radix<int> other;
+  auto nh = rdx.extract("https://example.org/a/very/long/path/that/is/split/here");
+  assert(nh.key() == "https://example.org/a/very/long/path/that/is/split/here");
+  other.insert(std::move(nh));
+  other.emplace("https://example.org/a/very/long/path/that/is/split/", 9);
+
+  auto it = other.begin();
+  assert(it->first == "https://example.org/a/very/long/path/that/is/split/");
+  assert((++it)->first == "https://example.org/a/very/long/path/that/is/split/here");
+  assert(++it == other.end());
+
+  auto [b_it, e_it] = rdx.complete("https://example.");
+  assert(b_it->first == "https://example.com/images/logo.png");
+  assert((++b_it)->first == "https://example.com/index.html");
+  assert((++b_it)->first == "https://example.org/a/very/long/path/that/is/not/split");
+  assert(++b_it == e_it);
+
+  // The common prefix is found in every block and in the tail that does not fill one
+  std::string base(100, 'k');
+  for (size_t i = 0; i < base.size(); ++i){
+    std::string changed = base;
+    changed[i] = 'K';
+    assert(xsm::detail::CommonPrefix(base, changed) == i);
+    assert(xsm::detail::CommonPrefix(base, base.substr(0, i)) == i);
+  }
+  assert(xsm::detail::CommonPrefix(base, base) == base.size());
+  assert(xsm::detail::CommonPrefix("", base) == 0);
+
+  return 0;
+}
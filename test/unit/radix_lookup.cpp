@@ -2,6 +2,8 @@
 #include "custom_comp.hpp"
 
 #include <exception>
+#include <string_view>
+#include <vector>
 
 int main() {
   {   
@@ -133,4 +135,61 @@ int main() {
     assert(it_lr == c_rdx.lower_bound(StartsWithK()));
     assert(it_ur == c_rdx.upper_bound(StartsWithK()));
   }
+
+  // Exact lookups with keys that are not std::string
+  {
+    xsm::radix<int> rdx = {{"waste", 1}, {"water", 2}, {"wa", 3}, {"watt", 4}};
+    const xsm::radix<int>& c_rdx = rdx;
+
+    const std::string_view view("water/ignored", 5);
+    const char* c_str = "watt";
+    const std::vector<char> chars = {'w', 'a'};
+
+    assert(rdx.find(view)->second == 2);
+    assert(c_rdx.find(c_str)->second == 4);
+    assert(rdx.find(chars)->second == 3);
+    assert(rdx.find(std::string_view("wat")) == rdx.end());
+    assert(rdx.find(std::string_view("waterproof")) == rdx.end());
+    assert(rdx.contains(view) && !rdx.contains(std::string_view("w")));
+    assert(rdx.count(chars) == 1);
+    assert(rdx.at(view) == 2);
+    assert(c_rdx.at(c_str) == 4);
+    try {
+      rdx.at(std::string_view("wat"));
+      assert(false);
+    }
+    catch (const std::out_of_range&){}
+
+    auto nh = rdx.extract(chars);
+    assert(nh.key() == "wa");
+    assert(rdx.extract(chars).empty());
+    assert(rdx.erase(view) == 1);
+    assert(rdx.erase(view) == 0);
+    assert(rdx.size() == 2);
+  }
+
+  // Bounds located byte by byte agree with the comparator walk of CompK, which orders alike
+  {
+    xsm::radix<int> rdx;
+    xsm::radix<int, xsm::comp::CompK> walk;
+    std::vector<std::string> queries = {"", "a", "b", "w", "wa", "wat", "water", "waterfall", "wb", "z", "\xff", "\x80" "a"};
+    for (std::string key : {"water", "waste", "wa", "watt", "worm", "wormhole", "b", "\x80", "\x80" "b", "\xff\xff"}){
+      rdx.emplace(key, 1);
+      walk.emplace(key, 1);
+      queries.push_back(key + "a");
+      queries.push_back(key.substr(0, key.size() - 1));
+    }
+    auto key_of = [](auto it, auto end){ return it == end? std::string("END") : it->first; };
+    for (const std::string& query : queries){
+      assert(key_of(rdx.lower_bound(query), rdx.end()) == key_of(walk.lower_bound(query), walk.end()));
+      assert(key_of(rdx.upper_bound(query), rdx.end()) == key_of(walk.upper_bound(query), walk.end()));
+      assert(key_of(rdx.lower_bound(std::string_view(query)), rdx.end()) == key_of(walk.lower_bound(query), walk.end()));
+      auto [b_it, e_it] = rdx.complete(query);
+      auto [wb_it, we_it] = walk.complete(query);
+      for (; wb_it != we_it; ++wb_it, ++b_it){
+        assert(b_it != e_it && b_it->first == wb_it->first);
+      }
+      assert(b_it == e_it);
+    }
+  }
 }
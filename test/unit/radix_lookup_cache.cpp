@@ -0,0 +1,104 @@
+#include <string>
+#include <cassert>
+#include "radix.hpp"
+
+typedef std::allocator<std::pair<const std::string,int>> std_alloc;
+typedef xsm::compact_pool_allocator<std::pair<const std::string,int>> compact_alloc;
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::lookup_cached<>>> cached_radix;
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::lookup_cached<1>>> single_slot_radix;
+typedef xsm::radix<int,std::less<std::string>,compact_alloc,xsm::radix_options<xsm::lookup_cached<64>>> compact_cached_radix;
+
+template <class Radix>
+void lookupCache(Radix& rdx){
+  for (int i = 0; i < 100; ++i){
+    rdx.emplace("key" + std::to_string(i), i);
+  }
+
+  // The first lookup of a key misses, repeated lookups hit
+  rdx.reset_cache_stats();
+  assert(rdx.at("key7") == 7);
+  assert(rdx.cache_stats().hits == 0 && rdx.cache_stats().misses == 1);
+  assert(rdx.find("key7")->second == 7);
+  assert(rdx.contains(std::string_view("key7")));
+  assert(rdx.count("key7") == 1);
+  assert(rdx["key7"] == 7);
+  assert(rdx.cache_stats().hits + rdx.cache_stats().misses == 5);
+
+  // Keys that share a slot replace each other and are still found
+  for (int round = 0; round < 3; ++round){
+    for (int i = 0; i < 100; ++i){
+      assert(std::as_const(rdx).find("key" + std::to_string(i))->second == i);
+    }
+  }
+  assert(!rdx.contains("key100"));
+
+  // Extracted and erased elements leave the cache
+  assert(rdx.at("key8") == 8);
+  auto nh = rdx.extract("key8");
+  assert(!rdx.contains("key8"));
+  nh.mapped() = 80;
+  rdx.insert(std::move(nh));
+  assert(rdx.at("key8") == 80);
+
+  assert(rdx.at("key9") == 9);
+  rdx.erase(rdx.find("key9"));
+  assert(rdx.find("key9") == rdx.end());
+  rdx.emplace("key9", 90);
+  assert(rdx.at("key9") == 90);
+
+  assert(rdx.at("key1") == 1);
+  assert(rdx.erase("key1") == 1);
+  assert(rdx.count("key1") == 0);
+
+  // The cache is exchanged with the tree, and emptied with it
+  Radix other(rdx.get_allocator());
+  other.emplace("key7", 70);
+  assert(other.at("key7") == 70);
+  other.swap(rdx);
+  assert(other.at("key7") == 7);
+  assert(rdx.at("key7") == 70);
+
+  other.clear();
+  assert(!other.contains("key7"));
+  other.emplace("key7", 700);
+  assert(other.at("key7") == 700);
+
+  // operator[] inserts missing keys
+  other["new"] = 1;
+  assert(other.at("new") == 1);
+}
+
+int main() {
+
+  {
+    cached_radix rdx;
+    lookupCache(rdx);
+  }
+  {
+    // Hot keys are answered by the cache
+    cached_radix rdx;
+    for (int i = 0; i < 100; ++i){
+      rdx.emplace("key" + std::to_string(i), i);
+    }
+    for (int i = 0; i < 1000; ++i){
+      rdx.find("key" + std::to_string(i % 4));
+    }
+    assert(rdx.cache_stats().hits >= 990);
+  }
+  {
+    single_slot_radix rdx;
+    lookupCache(rdx);
+  }
+
+  // The cache is allocated with the root node, from the same memory, and with compact links
+  xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+  {
+    compact_cached_radix rdx{compact_alloc(pool)};
+    assert(!rdx.contains("key"));
+    assert(pool.blocks_in_use() == 0);
+    lookupCache(rdx);
+  }
+  assert(pool.blocks_in_use() == 0);
+
+  return 0;
+}
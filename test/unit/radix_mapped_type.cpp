@@ -0,0 +1,52 @@
+#include <string>
+#include <cassert>
+#include "radix.hpp"
+
+// Mapped type without default constructor that counts its instances
+struct Counted{
+  static int instances;
+  int value;
+
+  explicit Counted(int v) : value(v) { ++instances; }
+  Counted(const Counted& other) : value(other.value) { ++instances; }
+  ~Counted() { --instances; }
+};
+int Counted::instances = 0;
+
+int main() {
+
+  {
+    xsm::radix<Counted> rdx;
+
+    // Keys diverge and are prefixes of each other, which creates non-leaf nodes
+    rdx.emplace("water", 1);
+    rdx.emplace("waste", 2);
+    rdx.emplace("well", 3);
+    rdx.emplace("wa", 4);
+
+    // Non-leaf nodes do not hold a mapped value
+    assert(Counted::instances == 4);
+    assert(rdx.at("water").value == 1);
+    assert(rdx.at("wa").value == 4);
+
+    // Extracting a node with several children leaves a non-leaf node behind
+    auto nh = rdx.extract("wa");
+    assert(nh.mapped().value == 4);
+    assert(Counted::instances == 4);
+
+    rdx.erase("water");
+    assert(Counted::instances == 3);
+
+    // Non-leaf node is substituted by a leaf node
+    rdx.insert(std::move(nh));
+    assert(rdx.find("wa")->second.value == 4);
+    assert(Counted::instances == 3);
+
+    xsm::radix<Counted> cpy = rdx;
+    assert(Counted::instances == 6);
+    assert(cpy.size() == rdx.size());
+  }
+  assert(Counted::instances == 0);
+
+  return 0;
+}
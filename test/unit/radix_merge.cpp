@@ -0,0 +1,201 @@
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include "radix_fixture.hpp"
+#include "custom_comp.hpp"
+
+int main() {
+
+  const std::vector<std::string> probes = {"", "a", "ab", "abc", "abcdefghijklmnop", "abcdefghijklmnopq", "ap",
+                                           "apple", "apples", "b", "k", "k4", "k9tail", "z"};
+
+  // A key of the other radix that ends inside a label splits the edge, and the subtree below
+  // it moves as a whole. The moved elements keep their address.
+  {
+    xsm::radix<int> rdx{{"apple", 1}, {"banana", 1}};
+    xsm::radix<int> other{{"apricot", 2}, {"apricots", 2}, {"cherry", 2}};
+    const int* apricot = &other.at("apricot");
+    const int* cherry = &other.at("cherry");
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"apple", 1}, {"apricot", 2}, {"apricots", 2}, {"banana", 1}, {"cherry", 2}}, probes);
+    assert(other.empty() && other.begin() == other.end());
+    assert(&rdx.at("apricot") == apricot && &rdx.at("cherry") == cherry);
+  }
+
+  // Keys that are in both stay in the other radix, keys at a label boundary or inside a label
+  // of this radix move
+  {
+    xsm::radix<int> rdx{{"apple", 1}, {"applesauce", 1}};
+    xsm::radix<int> other{{"app", 2}, {"apple", 2}, {"apples", 2}, {"applesauce", 2}};
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"app", 2}, {"apple", 1}, {"apples", 2}, {"applesauce", 1}}, probes);
+    assertEqual(other, map_type{{"apple", 2}, {"applesauce", 2}}, probes);
+  }
+
+  // A leaf that has children moves into the place of a node without an element, and its
+  // children are merged with the children of that node
+  {
+    xsm::radix<int> rdx{{"abc", 1}, {"abd", 1}, {"b", 1}};
+    xsm::radix<int> other{{"ab", 2}, {"abd", 2}, {"abx", 2}, {"abxy", 2}};
+    const int* ab = &other.at("ab");
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"ab", 2}, {"abc", 1}, {"abd", 1}, {"abx", 2}, {"abxy", 2}, {"b", 1}}, probes);
+    assertEqual(other, map_type{{"abd", 2}}, probes);
+    assert(&rdx.at("ab") == ab);
+
+    // ... and the children of a leaf of this radix take the children of the other node
+    xsm::radix<int> more{{"a", 3}, {"abe", 3}, {"abxz", 3}};
+    rdx.merge(more);
+    assert(more.empty());
+    assert(rdx.size() == 9 && rdx.at("a") == 3);
+    auto [first, last] = rdx.complete("abx");
+    assert(std::distance(first, last) == 3 && std::prev(last)->first == "abxz");
+  }
+
+  // Long labels, which leaves borrow from their key and other nodes allocate, are cut where
+  // the trees differ
+  {
+    const std::string alphabet = "abcdefghijklmnopqrstuvwxyz";
+    xsm::radix<int> rdx{{"a", 1}, {alphabet, 1}};
+    xsm::radix<int> other{{alphabet.substr(0, 16), 2}, {alphabet + "0123456789", 2}, {alphabet.substr(0, 22), 2},
+                          {alphabet, 2}};
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"a", 1}, {alphabet.substr(0, 16), 2}, {alphabet.substr(0, 22), 2}, {alphabet, 1},
+                              {alphabet + "0123456789", 2}}, probes);
+    assertEqual(other, map_type{{alphabet, 2}}, probes);
+    rdx.erase(alphabet.substr(0, 22));
+    assert(rdx.lower_bound(alphabet.substr(0, 17))->first == alphabet);
+  }
+
+  // Merging into an empty radix takes the whole tree, and merging an empty one changes nothing
+  {
+    xsm::radix<int> rdx;
+    xsm::radix<int> other{{"a", 2}, {"ab", 2}};
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"a", 2}, {"ab", 2}}, probes);
+    rdx.merge(other);
+    rdx.merge(xsm::radix<int>());
+    assert(rdx.size() == 2 && other.empty());
+  }
+
+  // The child map of a node grows when the moved children do not fit into its layout
+  {
+    xsm::radix<int> rdx;
+    xsm::radix<int> other;
+    map_type map;
+    for (int i = 0; i < 40; ++i){
+      rdx.emplace("k" + std::string(1, static_cast<char>('0' + i)), 1);
+      other.emplace("k" + std::string(1, static_cast<char>('0' + 20 + i)) + "tail", 2);
+      map.emplace("k" + std::string(1, static_cast<char>('0' + i)), 1);
+      map.emplace("k" + std::string(1, static_cast<char>('0' + 20 + i)) + "tail", 2);
+    }
+    rdx.merge(other);
+    assertEqual(rdx, map, probes);
+  }
+
+  // The root index, the hash index, the leaf links and the lookup cache of both trees follow
+  // the moved elements
+  {
+    typedef xsm::radix<int,std::less<std::string>,std_alloc,
+                       xsm::radix_options<xsm::root_indexed<>,xsm::hash_indexed<>,xsm::leaf_linked,xsm::lookup_cached<>>> radix;
+    radix rdx{{"abc", 1}, {"abd", 1}, {"b", 1}};
+    radix other{{"ab", 2}, {"abd", 2}, {"abx", 2}, {"c", 2}};
+    for (const std::string& probe : probes){
+      rdx.contains(probe);
+      other.contains(probe);
+    }
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"ab", 2}, {"abc", 1}, {"abd", 1}, {"abx", 2}, {"b", 1}, {"c", 2}}, probes);
+    assertEqual(other, map_type{{"abd", 2}}, probes);
+    assert(!other.contains("c") && other.find("ab") == other.end());
+  }
+
+  // Nodes from a pool keep their compact links
+  {
+    xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+    typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+    {
+      xsm::radix<int,std::less<std::string>,compact_alloc> rdx({{"abc", 1}, {"abd", 1}}, compact_alloc(pool));
+      xsm::radix<int,std::less<std::string>,compact_alloc> other({{"ab", 2}, {"abx", 2}, {"b", 2}}, compact_alloc(pool));
+      rdx.merge(other);
+      assertEqual(rdx, map_type{{"ab", 2}, {"abc", 1}, {"abd", 1}, {"abx", 2}, {"b", 2}}, probes);
+    }
+    assert(pool.blocks_in_use() == 0);
+  }
+
+  // Comparators other than the byte order
+  {
+    xsm::radix<int,xsm::comp::CompK> rdx{{"abc", 1}, {"k", 1}};
+    xsm::radix<int,xsm::comp::CompK> other{{"ab", 2}, {"abc", 2}, {"kx", 2}};
+    rdx.merge(other);
+    assertEqual(rdx, map_type{{"ab", 2}, {"abc", 1}, {"k", 1}, {"kx", 2}}, probes);
+    assert(other.size() == 1 && other.at("abc") == 2);
+
+    xsm::radix<int,std::greater<std::string>> g_rdx{{"a", 1}, {"c", 1}};
+    xsm::radix<int,std::greater<std::string>> g_other{{"b", 2}, {"c", 2}};
+    g_rdx.merge(g_other);
+    assert(g_rdx.size() == 3 && g_rdx.begin()->first == "c" && g_rdx.at("c") == 1);
+    assert(g_other.size() == 1);
+  }
+
+  // Allocators that are not equal move the elements into new nodes
+  {
+    Counter count, other_count;
+    failing_radix rdx({{"a", 1}, {"ab", 1}}, failing_alloc(count));
+    failing_radix other({{"ab", 2}, {"abc", 2}, {"b", 2}}, failing_alloc(other_count));
+    rdx.merge(other);
+    assert(rdx.size() == 4 && rdx.at("ab") == 1 && rdx.at("abc") == 2);
+    assert(other.size() == 1 && other.at("ab") == 2);
+  }
+
+  // Sets and self-merge
+  {
+    xsm::radix_set<> set{"a", "abc", "b"};
+    xsm::radix_set<> other{"ab", "abc", "c"};
+    set.merge(other);
+    set.merge(set);
+    assert(set.size() == 5 && other.size() == 1 && *other.begin() == "abc");
+  }
+
+  // A failed merge leaves all elements in one of the trees and no allocations behind
+  const map_type first{{"abc", 1}, {"abd", 1}, {"b", 1}};
+  const map_type second{{"ab", 2}, {"abd", 2}, {"abcdefghijklmnop", 2}, {"abx", 2}, {"c", 2}};
+  for (long limit = 0;; ++limit){
+    Counter count;
+    bool done = false;
+    {
+      failing_radix rdx(first.begin(), first.end(), failing_alloc(count));
+      failing_radix other(second.begin(), second.end(), failing_alloc(count));
+      count.limit = limit;
+      try {
+        rdx.merge(other);
+        done = true;
+      }
+      catch (const std::bad_alloc&) {}
+      count.limit = -1;
+
+      map_type all(rdx.begin(), rdx.end());
+      for (const auto& entry : other){
+        assert(!all.contains(entry.first) || first.contains(entry.first));
+        all.insert(entry);
+      }
+      map_type expected = first;
+      expected.insert(second.begin(), second.end());
+      assert(all == expected);
+      assert(rdx.size() == size_t(std::distance(rdx.begin(), rdx.end())));
+      assert(other.size() == size_t(std::distance(other.begin(), other.end())));
+      rdx.emplace("k0/new", 3);
+      other.emplace("k0/new", 3);
+    }
+    assert(count.live == 0);
+    if (done){
+      break;
+    }
+  }
+
+  return 0;
+}
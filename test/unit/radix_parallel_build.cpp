@@ -0,0 +1,136 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+typedef std::pair<std::string,int> element;
+
+int main() {
+
+  // Keys below a long common prefix, which is created on the way. The bucket of the digit 1
+  // holds more keys than a task takes and is partitioned again, and the keys that end right
+  // after the prefix or a digit fall into the bucket of their own. The duplicate of item 7
+  // and the empty key are dropped, like by insert().
+  const std::string prefix = "https://example.com/item/";
+  std::vector<element> elements;
+  for (int i = 4999; i >= 0; i -= 2){
+    elements.emplace_back(prefix + std::to_string(i), i);
+  }
+  elements.emplace_back(prefix + "7", -7);
+  elements.emplace_back("", -1);
+  elements.emplace_back(prefix, -2);
+  for (int i = 0; i < 5000; i += 2){
+    elements.emplace_back(prefix + std::to_string(i), i);
+  }
+  map_type map;
+  for (const element& e : elements){
+    if (!e.first.empty()){
+      map.insert(e);
+    }
+  }
+  const std::vector<std::string> probes = {"", "https://", prefix, prefix + "1", prefix + "10", prefix + "1000",
+                                           prefix + "19999", prefix + "7", prefix + "~", "z"};
+
+  // The result does not depend on the number of threads
+  for (unsigned threads : {1u, 2u, 5u}){
+    xsm::radix<int> rdx;
+    rdx.insert_parallel(elements.begin(), elements.end(), threads);
+    assertEqual(rdx, map, probes);
+    assert(rdx.at(prefix + "7") == 7);
+    assert(!rdx.contains(""));
+  }
+
+  // The tree is the same as the one built by single insertions
+  {
+    Counter parallel_count;
+    Counter single_count;
+    failing_radix rdx{failing_alloc(parallel_count)};
+    rdx.insert_parallel(elements.begin(), elements.end(), 4);
+    failing_radix single{failing_alloc(single_count)};
+    for (const element& e : elements){
+      single.insert(e);
+    }
+    assert(parallel_count.live == single_count.live);
+
+    // ... and stays consistent under later modifications
+    assert(rdx.erase(prefix + "1") == 1);
+    assert(rdx.erase(prefix) == 1);
+    rdx.emplace(prefix + "1a", 1);
+    auto it = rdx.find(prefix + "0");
+    assert((++it)->first == prefix + "10");
+    assert(rdx.lower_bound(prefix + "1")->first == prefix + "10");
+    assert(rdx.find(prefix + "1a") == std::prev(rdx.lower_bound(prefix + "2")));
+  }
+
+  // The hash index, the leaf links and the root index are filled after the tree is built
+  {
+    xsm::radix<int,std::less<std::string>,std_alloc,
+               xsm::radix_options<xsm::root_indexed<>,xsm::hash_indexed<>,xsm::leaf_linked,xsm::lookup_cached<>>> rdx;
+    rdx.insert_parallel(elements.begin(), elements.end(), 3);
+    assertEqual(rdx, map, probes);
+    auto [first, last] = rdx.complete(prefix + "499");
+    assert(first->first == prefix + "499" && (++first)->first == prefix + "4990");
+    assert(std::distance(first, last) == 10);
+  }
+
+  // Pool allocators cannot be used on several threads, so the tree is built on this one
+  {
+    xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+    typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+    {
+      xsm::radix<int,std::less<std::string>,compact_alloc> rdx{compact_alloc(pool)};
+      rdx.insert_parallel(elements.begin(), elements.end(), 4);
+      assertEqual(rdx, map, probes);
+    }
+    assert(pool.blocks_in_use() == 0);
+  }
+
+  // Other comparators, and a radix that is not empty, insert one by one
+  {
+    xsm::radix<int,std::greater<std::string>> rdx;
+    std::vector<element> few{{"b", 1}, {"c", 2}, {"a", 3}, {"b", 4}};
+    rdx.insert_parallel(few.begin(), few.end(), 4);
+    assert(rdx.size() == 3 && rdx.begin()->first == "c" && rdx.at("b") == 1);
+    assert(std::prev(rdx.end())->first == "a");
+
+    xsm::radix<int> filled{{prefix + "1", -1}, {"a", 0}};
+    filled.insert_parallel(elements.begin(), elements.end(), 4);
+    assert(filled.size() == map.size() + 1);
+    assert(filled.at(prefix + "1") == -1 && filled.at(prefix + "2") == 2);
+  }
+
+  // Sets
+  {
+    std::vector<std::string> keys;
+    for (const element& e : elements){
+      keys.push_back(e.first);
+    }
+    xsm::radix_set<> set;
+    set.insert_parallel(keys.begin(), keys.end(), 3);
+    assert(set.size() == map.size());
+    assert(*set.begin() == prefix && *std::prev(set.end()) == prefix + "999");
+  }
+
+  // A failed build leaves the radix empty and no allocations behind
+  for (long limit : {0L, 1L, 2L, 1000L, 4000L}){
+    Counter count;
+    {
+      failing_radix rdx{failing_alloc(count)};
+      count.limit = limit;
+      try {
+        rdx.insert_parallel(elements.begin(), elements.end(), 3);
+        assert(false);
+      }
+      catch (const std::bad_alloc&) {
+        assert(rdx.empty() && rdx.begin() == rdx.end());
+      }
+      count.limit = -1;
+      rdx.emplace("a", 1);
+      assert(rdx.size() == 1);
+    }
+    assert(count.live == 0);
+  }
+
+  return 0;
+}
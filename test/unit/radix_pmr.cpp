@@ -0,0 +1,81 @@
+#include <string>
+#include <cassert>
+#include <memory_resource>
+#include "radix.hpp"
+
+// Memory resource that counts the blocks it hands out
+class Counting_resource : public std::pmr::memory_resource{
+  public:
+    long live = 0;
+    long total = 0;
+
+  private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+      ++live;
+      ++total;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+      --live;
+      std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+      return this == &other;
+    }
+};
+
+int main() {
+
+  // Nodes, edge labels and child maps come from the resource of the radix
+  Counting_resource resource;
+  {
+    xsm::pmr::radix<int> rdx(&resource);
+    assert(rdx.get_allocator().resource() == &resource);
+    for (int c = 1; c < 256; ++c){
+      rdx.emplace(std::string(1, static_cast<char>(c)), c);
+      rdx.emplace(std::string(1, static_cast<char>(c)) + "a/long/label", -c);
+      rdx.emplace(std::string(1, static_cast<char>(c)) + "a/long/label/split", c);
+    }
+    assert(resource.live > 3 * 255);
+    assert(rdx.at("za/long/label") == -'z');
+
+    // Node handles move between instances on the same resource without a new allocation
+    xsm::pmr::radix<int> other(&resource);
+    const long total = resource.total;
+    auto nh = rdx.extract("za/long/label/split");
+    assert(nh.get_allocator().resource() == &resource);
+    auto result = other.insert(std::move(nh));
+    assert(result.inserted);
+    assert(other.at("za/long/label/split") == 'z');
+    // Only the root of the formerly empty radix is allocated
+    assert(resource.total == total + 1);
+
+    // ... and are copied into instances on other resources
+    xsm::pmr::radix<int> elsewhere;
+    elsewhere.insert(other.extract("za/long/label/split"));
+    assert(elsewhere.at("za/long/label/split") == 'z');
+    assert(elsewhere.get_allocator().resource() == std::pmr::get_default_resource());
+  }
+  assert(resource.live == 0);
+
+  // A whole index on a monotonic buffer, without touching the heap
+  {
+    static char buffer[1 << 18];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    {
+      xsm::pmr::radix<int> rdx(&arena);
+      for (int i = 0; i < 500; ++i){
+        rdx.emplace("k" + std::to_string(i), i);
+      }
+      for (int i = 0; i < 500; ++i){
+        assert(rdx.at("k" + std::to_string(i)) == i);
+      }
+      rdx.erase("k42");
+      assert(!rdx.contains("k42"));
+      assert(rdx.size() == 499);
+    }
+    arena.release();
+  }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <map>
+#include <string>
+#include <iterator>
+#include <cassert>
+#include "radix_fixture.hpp"
+
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::root_indexed<1>>> indexed_radix_1;
+typedef xsm::radix<int,std::less<std::string>,std_alloc,xsm::radix_options<xsm::root_indexed<2>>> indexed_radix_2;
+typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+typedef xsm::radix<int,std::less<std::string>,compact_alloc,xsm::radix_options<xsm::root_indexed<>,xsm::leaf_linked>> compact_indexed_radix;
+
+int main() {
+
+  // The radix holds a pointer to the index
+  static_assert(sizeof(indexed_radix_2) == sizeof(xsm::radix<int>) + sizeof(void*));
+
+  const std::vector<std::string> probes = {"", "a", "ab", "abc", "abd", "abcd", "b", "ba", "bab", "c", "zz", "\xff", "\xff\xff"};
+
+  {
+    indexed_radix_2 rdx;
+    map_type map;
+
+    // Nodes within the first two bytes are added, split and substituted
+    int value = 0;
+    for (const char* key : {"abcd", "abce", "ab", "a", "abc", "b", "bab", "ba", "bb", "c", "\xff", "\xff\xff"}){
+      rdx.emplace(key, ++value);
+      map.emplace(key, value);
+      assertEqual(rdx, map, probes);
+    }
+    auto [b_it, e_it] = rdx.complete("ab");
+    assert(b_it->first == "ab" && std::distance(b_it, e_it) == 4);
+    std::tie(b_it, e_it) = rdx.complete("\xff");
+    assert(b_it->first == "\xff" && std::next(b_it, 2) == e_it);
+
+    // Elements inserted with a hint or from a node handle
+    rdx.emplace_hint(rdx.find("bab"), "baa", ++value);
+    map.emplace("baa", value);
+    auto nh = rdx.extract("ab");
+    map.erase("ab");
+    assertEqual(rdx, map, probes);
+    rdx.insert(std::move(nh));
+    map.emplace("ab", 3);
+    assertEqual(rdx, map, probes);
+
+    // Nodes within the first two bytes are removed and merged, until "abce" hangs below the root
+    for (const char* key : {"a", "abc", "abcd", "ab", "ba", "bab", "baa", "\xff"}){
+      assert(rdx.erase(key) == map.erase(key));
+      assertEqual(rdx, map, probes);
+    }
+    std::tie(b_it, e_it) = rdx.complete("ab");
+    assert(b_it->first == "abce" && std::next(b_it) == e_it);
+
+    // The index moves with the tree
+    indexed_radix_2 cpy = rdx;
+    assertEqual(cpy, map, probes);
+    indexed_radix_2 other;
+    other.swap(cpy);
+    assertEqual(other, map, probes);
+    indexed_radix_2 moved(std::move(other));
+    assertEqual(moved, map, probes);
+
+    rdx.clear();
+    assertEqual(rdx, map_type(), probes);
+    rdx.emplace("ab", 1);
+    assertEqual(rdx, map_type{{"ab", 1}}, probes);
+  }
+
+  // A one byte index points to the node of the first byte, or to the root while there is none
+  {
+    indexed_radix_1 rdx{{"abcd", 1}, {"abce", 2}, {"b", 3}};
+    map_type map{{"abcd", 1}, {"abce", 2}, {"b", 3}};
+    assertEqual(rdx, map, probes);
+    rdx.emplace("a", 4);
+    map.emplace("a", 4);
+    rdx.erase("b");
+    map.erase("b");
+    assertEqual(rdx, map, probes);
+    auto [b_it, e_it] = rdx.complete("abc");
+    assert(b_it->first == "abcd" && std::distance(b_it, e_it) == 2);
+  }
+
+  // The index is allocated with the root node, from the same memory, and with compact links.
+  // It can be combined with leaf links.
+  xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+  {
+    compact_indexed_radix rdx{compact_alloc(pool)};
+    assert(pool.blocks_in_use() == 0);
+    map_type map{{"a", 1}, {"ab", 2}, {"abc", 3}, {"b", 4}, {"\xff\xff", 5}};
+    rdx.insert(map.begin(), map.end());
+    assertEqual(rdx, map, probes);
+    rdx.erase("ab");
+    map.erase("ab");
+    assertEqual(rdx, map, probes);
+
+    // A cut that moves nothing leaves the new radix without a root and a table
+    size_t blocks = pool.blocks_in_use();
+    compact_indexed_radix none = rdx.extract_prefix("no such prefix");
+    assert(none.empty() && pool.blocks_in_use() == blocks);
+
+    rdx.clear();
+    assert(pool.blocks_in_use() == 0);
+  }
+  assert(pool.blocks_in_use() == 0);
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <set>
+#include <string>
+#include <vector>
+#include <cassert>
+#include "radix.hpp"
+
+int main() {
+
+  typedef xsm::radix_set<> set_type;
+
+  // Leaf nodes store the key without a mapped value. Nodes are complete once their radix is.
+  static_assert(sizeof(set_type) == sizeof(xsm::radix<bool>));
+  static_assert(sizeof(xsm::detail::Leaf_node<xsm::detail::Key_only,std::less<std::string>,std::allocator<std::string>,xsm::radix_options<>>)
+      < sizeof(xsm::detail::Leaf_node<bool,std::less<std::string>,std::allocator<std::pair<const std::string,bool>>,xsm::radix_options<>>));
+  static_assert(std::is_same_v<set_type::value_type, std::string>);
+  static_assert(std::is_same_v<set_type::iterator::reference, const std::string&>);
+  static_assert(std::bidirectional_iterator<set_type::iterator>);
+
+  {
+    // Same order and contents as std::set
+    std::vector<std::string> words = {"water", "waste", "wa", "w", "art", "beast", "kilo", "koala", "knight", "zebra"};
+    set_type set;
+    std::set<std::string> reference;
+    for (const auto& word : words){
+      auto result = set.insert(word);
+      assert(result.second);
+      assert(*result.first == word);
+      reference.insert(word);
+    }
+    assert(!set.insert("water").second);
+    assert(!set.emplace("wa").second);
+    assert(set.size() == reference.size());
+    assert(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+
+    assert(set.contains("waste"));
+    assert(!set.contains("was"));
+    assert(set.count("kilo") == 1);
+    assert(*set.find("koala") == "koala");
+    assert(set.find("koal") == set.end());
+    assert(*set.lower_bound("k") == "kilo");
+    assert(*set.upper_bound("wa") == "waste");
+
+    // Complete
+    auto [b_it, e_it] = set.complete("k");
+    assert(*b_it == "kilo");
+    assert(*++b_it == "knight");
+    assert(*++b_it == "koala");
+    assert(++b_it == e_it);
+
+    // Erase
+    assert(set.erase("wa") == 1);
+    assert(set.erase("wa") == 0);
+    assert(*set.lower_bound("wa") == "waste");
+
+    // Node handles
+    set_type other = {"other"};
+    auto nh = set.extract("beast");
+    assert(nh.value() == "beast");
+    assert(nh.key() == "beast");
+    auto result = other.insert(std::move(nh));
+    assert(result.inserted);
+    assert(!set.contains("beast"));
+    assert(other.size() == 2);
+    assert(*other.begin() == "beast");
+
+    // Copy and move
+    set_type cpy = set;
+    assert(std::equal(cpy.begin(), cpy.end(), set.begin(), set.end()));
+    set_type moved = std::move(cpy);
+    assert(cpy.empty());
+    assert(moved.size() == set.size());
+  }
+
+  // Sets on a memory resource
+  {
+    xsm::pmr::radix_set<> set(std::pmr::new_delete_resource());
+    set.insert("pmr");
+    set.insert("pmr/set");
+    xsm::pmr::radix_set<> elsewhere;
+    elsewhere.insert(set.extract("pmr/set"));
+    assert(elsewhere.contains("pmr/set"));
+    assert(set.size() == 1);
+  }
+
+  return 0;
+}
@@ -0,0 +1,194 @@
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include "radix_fixture.hpp"
+#include "custom_comp.hpp"
+
+int main() {
+
+  // "ap" has the children "p" and "ricot", the leaf "app" has the child "le", which has the child
+  // "sauce", and the labels below "https://example." are longer than the inline storage of a label
+  const map_type elements{{"a", 1}, {"ab", 2}, {"abc", 3}, {"abd", 4}, {"app", 5}, {"apple", 6}, {"applesauce", 7},
+                          {"apricot", 8}, {"b", 9}, {"https://example.com/a", 10}, {"https://example.com/a/b", 11},
+                          {"https://example.com/b/long/label/that/spills", 12}, {"https://example.org/", 13}};
+  const std::vector<std::string> probes = {"", "a", "ab", "abc", "ap", "app", "appl", "apple", "apples", "apr", "b",
+                                           "c", "https://example.", "https://example.com/", "https://example.com/a/",
+                                           "https://example.com/b", "https://example.org/", "z"};
+
+  // Splits at a key, and extracts a prefix, from a radix of the elements. The moved elements
+  // keep their address, and the parts are merged again afterwards.
+  for (const auto& [key, first_moved] : {std::pair<std::string,std::string>("", "a"),
+                                         {"ab", "ab"},                     // Label boundary
+                                         {"abb", "abc"},                   // Between children
+                                         {"apo", "app"},                   // Before a child
+                                         {"appla", "apple"},               // Inside a label, before it
+                                         {"applf", "apricot"},             // Inside a label, after it
+                                         {"apple", "apple"},               // Leaf that has children
+                                         {"apples", "applesauce"},         // Below a leaf that has children
+                                         {"https://example.com/a/", "https://example.com/a/b"},
+                                         {"https://example.com/b/long/label/", "https://example.com/b/long/label/that/spills"},
+                                         {"https://example.n", "https://example.org/"},
+                                         {"z", ""}}){
+    xsm::radix<int> rdx(elements.begin(), elements.end());
+    const int* address = first_moved.empty()? nullptr : &rdx.at(first_moved);
+    xsm::radix<int> other = rdx.split(key);
+
+    map_type kept, moved;
+    for (const auto& entry : elements){
+      (entry.first < key? kept : moved).insert(entry);
+    }
+    assertEqual(rdx, kept, probes);
+    assertEqual(other, moved, probes);
+    assert(first_moved.empty()? other.empty() : other.begin()->first == first_moved);
+    assert(!address || &other.at(first_moved) == address);
+
+    // Both parts stay consistent under later modifications
+    rdx.emplace("apples", 0);
+    other.emplace("apples", 0);
+    rdx.merge(other);
+    map_type all = elements;
+    all.emplace("apples", 0);
+    assertEqual(rdx, all, probes);
+    assert(other.size() == 1 && other.at("apples") == 0);
+  }
+
+  for (const auto& [prefix, moves] : {std::pair<std::string,size_t>("", 13),
+                                      {"ab", 3},                   // Label boundary
+                                      {"appl", 2},                 // Inside a label
+                                      {"apple", 2},                // Leaf that has children
+                                      {"applesauce", 1},           // Leaf without children
+                                      {"https://example.co", 3},   // Inside a long label
+                                      {"https://example.com/a/", 1},
+                                      {"apz", 0},
+                                      {"c", 0}}){
+    xsm::radix<int> rdx(elements.begin(), elements.end());
+    const int* address = moves? &rdx.lower_bound(prefix)->second : nullptr;
+    xsm::radix<int> other = rdx.extract_prefix(prefix);
+
+    map_type kept, moved;
+    for (const auto& entry : elements){
+      (entry.first.starts_with(prefix)? moved : kept).insert(entry);
+    }
+    assert(moved.size() == moves);
+    assertEqual(rdx, kept, probes);
+    assertEqual(other, moved, probes);
+    assert(!address || &other.begin()->second == address);
+
+    rdx.merge(other);
+    assertEqual(rdx, elements, probes);
+  }
+
+  // Nothing to move allocates nothing
+  {
+    Counter count;
+    failing_radix rdx(elements.begin(), elements.end(), failing_alloc(count));
+    long live = count.live;
+    failing_radix upper = rdx.split("z");
+    failing_radix prefixed = rdx.extract_prefix("apz");
+    assert(count.live == live && upper.empty() && prefixed.empty());
+  }
+
+  // The root index, the hash index, the leaf links and the lookup cache of both parts follow the
+  // moved elements
+  {
+    typedef xsm::radix<int,std::less<std::string>,std_alloc,
+                       xsm::radix_options<xsm::root_indexed<>,xsm::hash_indexed<>,xsm::leaf_linked,xsm::lookup_cached<>>> radix;
+    radix rdx(elements.begin(), elements.end());
+    for (const std::string& probe : probes){
+      rdx.contains(probe);
+    }
+    radix other = rdx.split("apples");
+    radix prefixed = other.extract_prefix("https://example.com");
+    assertEqual(rdx, map_type(elements.begin(), elements.find("applesauce")), probes);
+    assertEqual(prefixed, map_type(elements.find("https://example.com/a"), elements.find("https://example.org/")), probes);
+    assertEqual(other, map_type{{"applesauce", 7}, {"apricot", 8}, {"b", 9}, {"https://example.org/", 13}}, probes);
+    auto [first, last] = other.complete("ap");
+    assert(std::distance(first, last) == 2);
+  }
+
+  // Nodes from a pool keep their compact links
+  {
+    xsm::node_pool pool(1 << 16, false, size_t(1) << 30);
+    typedef xsm::compact_pool_allocator<value_type> compact_alloc;
+    {
+      xsm::radix<int,std::less<std::string>,compact_alloc> rdx(elements.begin(), elements.end(), compact_alloc(pool));
+      auto other = rdx.split("apples");
+      auto prefixed = other.extract_prefix("https://example.com");
+      assertEqual(rdx, map_type(elements.begin(), elements.find("applesauce")), probes);
+      assert(other.size() == 4 && prefixed.size() == 3);
+    }
+    assert(pool.blocks_in_use() == 0);
+  }
+
+  // With other comparators, the elements from the lower bound on move in the order of the
+  // comparator. CompK orders like the byte order, but its children are compared with it.
+  {
+    xsm::radix<int,xsm::comp::CompK> rdx(elements.begin(), elements.end());
+    auto other = rdx.split("apples");
+    auto prefixed = other.extract_prefix("https://example.co");
+    assertEqual(rdx, map_type(elements.begin(), elements.find("applesauce")), probes);
+    assertEqual(prefixed, map_type(elements.find("https://example.com/a"), elements.find("https://example.org/")), probes);
+    assert(other.size() == 4 && other.begin()->first == "applesauce");
+    rdx.merge(other);
+    rdx.merge(prefixed);
+    assertEqual(rdx, elements, probes);
+
+    xsm::radix<int,std::greater<std::string>> g_rdx{{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}};
+    auto g_other = g_rdx.split("b");
+    assert(g_rdx.size() == 2 && g_rdx.begin()->first == "d");
+    assert(g_other.size() == 2 && g_other.begin()->first == "b");
+  }
+
+  // Sets
+  {
+    xsm::radix_set<> set{"a", "abc", "abd", "b"};
+    xsm::radix_set<> upper = set.split(std::string_view("abd"));
+    xsm::radix_set<> prefixed = set.extract_prefix("ab");
+    assert(set.size() == 1 && *set.begin() == "a");
+    assert(prefixed.size() == 1 && *prefixed.begin() == "abc");
+    assert(upper.size() == 2 && *upper.begin() == "abd");
+  }
+
+  // A failed cut leaves the radix unchanged and no allocations behind, also when the children
+  // are ordered by the comparator
+  for (const char* key : {"apples", "https://example.com/a/", "https://example.co"}){
+    for (bool split : {true, false}){
+      for (bool comp_k : {false, true}){
+        for (long limit = 0;; ++limit){
+          Counter count;
+          bool done = false;
+          {
+            failing_radix rdx(elements.begin(), elements.end(), failing_alloc(count));
+            xsm::radix<int,xsm::comp::CompK,failing_alloc> k_rdx(elements.begin(), elements.end(), failing_alloc(count));
+            count.limit = limit;
+            try {
+              if (comp_k){
+                auto other = split? k_rdx.split(key) : k_rdx.extract_prefix(key);
+              }
+              else {
+                failing_radix other = split? rdx.split(key) : rdx.extract_prefix(key);
+              }
+              done = true;
+            }
+            catch (const std::bad_alloc&) {
+              count.limit = -1;
+              assertEqual(rdx, elements, probes);
+              assertEqual(k_rdx, elements, probes);
+            }
+            count.limit = -1;
+          }
+          assert(count.live == 0);
+          if (done){
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}